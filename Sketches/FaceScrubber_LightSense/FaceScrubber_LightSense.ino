@@ -47,9 +47,8 @@ static VariableResponse ledResponse(RfBf, 1.5, 3.5); // Will monitor RfBf and gi
 
 void setup()
 {
-    // Create some curves. Here, I am making one out of an existing template. #DataDrivenDesign
-    Curve whiteResponseCurve(W_CoolWarmResponse, sizeof(W_CoolWarmResponse)/sizeof(Key));
-    ledResponse.SetResponseCurve(whiteResponseCurve);
+    // Create some curves. Here, I am using an existing template, straight from flash. #DataDrivenDesign
+    ledResponse.SetResponseCurve(CurveView(W_CoolWarmResponse, KARR_LEN(W_CoolWarmResponse)));
 
     // If you want custom curves, either statically initialize one in ResponseCurves.h or create one on the spot
     Curve invSquareCurve(3); // 3 being a capacity hint for how many points are in the curve
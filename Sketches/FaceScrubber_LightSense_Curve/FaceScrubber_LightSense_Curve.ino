@@ -13,6 +13,9 @@
 #define STOP_BYTE (0X7F)
 #define CHANNELS_COUNT (16)
 
+/* Rate of the binary telemetry records replacing the old debug prints, see Telemetry.h */
+#define TELEMETRY_INTERVAL (200)
+
 // Returns the nth bit in x
 #define BIT(x, n) (1 << n & x)
 #define TOP_PANEL_MASK      0x0
@@ -66,6 +69,7 @@ void setup()
     Serial.begin(9600); // for some reason, any other value causes issues. Cant light LED. Maybe android side bug when selecting baud rate?
     Serial.println("Starting...");
     Serial.flush();
+    Telemetry::SetInterval(TELEMETRY_INTERVAL);
 
     tlcmanager.init();
     ledPanel = new LedPanel(tlcmanager);
@@ -81,17 +85,9 @@ void setup()
     }
 
     // Assign the response curve for white light
-    Curve W_ResponseCurve(W_CoolWarmResponse, KARR_LEN(W_CoolWarmResponse));
-    Curve Y_ResponseCurve(Y_CoolWarmResponse, KARR_LEN(Y_CoolWarmResponse));
-    Curve R_ResponseCurve(R_CCResponse, KARR_LEN(R_CCResponse));
-    
-    W_ResponseCurve.Rebuild();
-    Y_ResponseCurve.Rebuild();
-    R_ResponseCurve.Rebuild();
-    
-    W_LedResponse.SetResponseCurve(W_ResponseCurve);
-    Y_LedResponse.SetResponseCurve(Y_ResponseCurve);
-    R_LedResponse.SetResponseCurve(R_ResponseCurve);
+    W_LedResponse.SetResponseCurve(CurveView(W_CoolWarmResponse, KARR_LEN(W_CoolWarmResponse)));
+    Y_LedResponse.SetResponseCurve(CurveView(Y_CoolWarmResponse, KARR_LEN(Y_CoolWarmResponse)));
+    R_LedResponse.SetResponseCurve(CurveView(R_CCResponse, KARR_LEN(R_CCResponse)));
 
     g_CurrTime = millis()/1000.f;
     
@@ -109,11 +105,11 @@ void loop()
 {   
 
   PollSerialEvents();
+  Telemetry::Flush(Serial);
   
   if (mode == 9) {
   // Important: Must be EQUAL to packet size. Failure to do so introduces oddities in the transmission
   // That makes us respond at later steps - confuses the hell out of UI.
-Serial.print("Max: "); Serial.println(_max);
     
   // Read sensor values (16 bit integers)
   float red = RGB_sensor.readRed();
@@ -139,8 +135,13 @@ Serial.print("Max: "); Serial.println(_max);
 //  //Serial.print("Rf/Gf: "); Serial.println(RGf);
 //
 
-  Serial.print("InvRedf: "); Serial.println(Rf);
-  Serial.print("Rf/Bf: "); Serial.println(RBf);
+  if (Telemetry::IsDue(ETelemetryRecord::SENSOR)) {
+    TelemetryRecord(ETelemetryRecord::SENSOR)
+      .PutU16((uint16_t)red).PutU16((uint16_t)green).PutU16((uint16_t)blue)
+      .PutQ8_8(Rf)
+      .PutQ8_8(RBf)
+      .Send();
+  }
 //  //Serial.print("Gf/Bf: "); Serial.println(GBf);
 
   //float delta = tempDelta(RBf);
@@ -148,9 +149,16 @@ Serial.print("Max: "); Serial.println(_max);
   float Y_response = Y_LedResponse.GetValue();
   float R_response = R_LedResponse.GetValue();
   
-  Serial.print("Parameter t = "); Serial.println(W_LedResponse.DebugGetParameter());
-  Serial.print("Cool Response Value = "); Serial.println(W_response);
-  Serial.print("Warm Response Value = "); Serial.println(Y_response);
+  if (Telemetry::IsDue(ETelemetryRecord::COLOR_RESPONSE)) {
+    TelemetryRecord(ETelemetryRecord::COLOR_RESPONSE)
+      .PutQ8_8(RBf)
+      .PutQ8_8(_max)
+      .PutUQ0_16(W_LedResponse.DebugGetParameter())
+      .PutUQ0_16(W_response)
+      .PutUQ0_16(Y_response)
+      .PutUQ0_16(R_response)
+      .Send();
+  }
 
 //
 //  Serial.print("Parameter t2 = "); Serial.println(Y_LedResponse.DebugGetParameter());
@@ -319,8 +327,6 @@ Serial.print("Max: "); Serial.println(_max);
   g_CurrTime = (millis()/1000.f);
   
   ledPanel->Update(deltaTime);
-
-  Serial.println();
   
   delay(5);
   
@@ -9,13 +9,10 @@
 
 #include <Wire.h>
 
-/* Serial Transmission Params */
-#define START_BYTE (0x20)
-#define STOP_BYTE (0X7F)
-#define CHANNELS_COUNT (16)
-#define MSG_TIMEOUT (5000) /*ms*/
-
-#define FIXED_MSG_SIZE
+/* Serial Transmission Params, see ProtocolFraming.h for the message format */
+#define SERIAL_BAUD (115200) /* A streamed frame is ~73 bytes on the wire, 30fps needs at least 38400 baud */
+#define SERIAL_RING_CAPACITY (128) /* Power of two, holds a few messages worth of bursts */
+#define LOOP_PAUSE (5) /* ms between loops, unless streaming */
 
 static int bIsPaused = 0;
 
@@ -28,11 +25,16 @@ LedPanel* ledPanel = new LedPanel(tlcmanager);
 Context* gContext = new Context(*ledPanel, RGB_sensor);
 EffectRegistry effectRegistry;
 
+/* Received bytes, drained from the core's small RX buffer every loop */
+ByteRing<SERIAL_RING_CAPACITY> serialRing;
+FrameStream frameStream(*ledPanel);
+ProtocolHandler protocol(effectRegistry, frameStream, Serial);
+
 float g_CurrTime = 0;
 
 void setup() 
 {
-    Serial.begin(9600); // for some reason, any other value causes issues. Cant light LED. Maybe android side bug when selecting baud rate?
+    Serial.begin(SERIAL_BAUD); // Host must match, older apps assumed 9600
     LOGN("Starting...");
     Serial.flush();
     
@@ -40,6 +42,9 @@ void setup()
     ledPanel->Init();
     LOGN("Init Panel");
     Serial.flush();
+
+    // A full panel write takes longer than the UART buffer lasts, keep draining it between drivers
+    ledPanel->SetWriteCallback([]() { serialRing.Fill(Serial); });
     
     // Initialize the ISL29125 with simple configuration so it starts sampling
     if (RGB_sensor.init())
@@ -52,11 +57,15 @@ void setup()
       Serial.flush();
       abort();
     }
+
+    // Switch the sensor to conversion-done interrupts so that each sample is only read once
+    gContext->Sampler.Init();
+
     // Led Panel must be fully initialized before using this
     effectRegistry.Init();
     LOGN("Effects Init");
     
-    effectRegistry.ActivateEffect(0);
+    effectRegistry.ActivateEffect(EffectId<ColorCorrectEffect>());
     
     g_CurrTime = millis()/1000.f;
     delay(25);
@@ -70,172 +79,30 @@ void loop()
   g_CurrTime = (millis()/1000.f);
 
   // Respond to any serial transmissions if any
-  PollSerialEvents();
+  serialRing.Fill(Serial);
+  protocol.Process(serialRing);
+
+  // Diagnostics go out as binary records, only as fast as the UART takes them
+  Telemetry::Flush(Serial);
+
+  // Streamed frames go straight to the hardware, before the panel would start interpolating towards them
+  frameStream.Update();
 
   // Update All Lumetix sub-systems
+  gContext->Sampler.Update();
   ledPanel->Update(deltaTime);
   effectRegistry.Update(deltaTime);
-  
-  delay(5);
-}
-
-void PollSerialEvents()
-{
-    // Received potential START_BYTE and header
-    if(Serial.available() >= 3)
-    {
-        Serial.println("HERE");
-        ledPanel->TurnOff(true);
-        delay(50);
-        
-        byte data = Serial.read();
-        if(data == START_BYTE)
-        {
-            ledPanel->TurnOn(true);
-            delay(150);
-            Serial.println("START BYTE");
-            
-            // Header indicating message size
-            #ifndef FIXED_MSG_SIZE
-            byte msgSize = Serial.read();
-            #else
-            byte msgSize = 2;
-            #endif
-
-            // Message has no content, probably corrupt. Ignore
-            if(msgSize < 1)
-              flushSerialInput();
-
-            // A transmission time-out occured, and not all data was successfully retrieved
-            if(!WaitForData(msgSize))
-              return;
-            
-            //int effectId = (int)Serial.read();
-            byte effectId = Serial.read();
-
-            if(effectId == 1)
-            {
-                ledPanel->bInterpolates = false;
-                ledPanel->SetBrightness(ELedColor::GREEN, 255, EUpdateMode::ZERO_UNSELECTED);
-                ledPanel->Update(1.f);
-                delay(1000);
-            }
-            else if(effectId == 50) // ascii character representing '1'
-            {
-                ledPanel->bInterpolates = false;
-                ledPanel->SetBrightness(ELedColor::RED, 255, EUpdateMode::ZERO_UNSELECTED);
-                ledPanel->Update(1.f);
-                while(1) {}
-            }
-            if(effectId >= 2 && effectId <= 11)
-              effectId = 3;
-            
-            EffectArgs outEffectArgs;
-            ParseEffectArgs(effectId, --msgSize, outEffectArgs);
-
-            effectRegistry.ActivateEffect(effectId);
-            effectRegistry.NotifyArgsChanged(outEffectArgs);
-
-            flushSerialInput();
-        }
-    }
-}
-
-bool WaitForData(byte remainingSize)
-{
-    /* Wait on serial until all data from transmission arrives safely */
-    unsigned long timestamp = millis();
-    while( (millis() - timestamp < MSG_TIMEOUT) && (Serial.available() < remainingSize))
-    {
-    }
 
-    /* Tranmission Timeout, flush the serial buffer */
-    if(Serial.available() < remainingSize)
+  // The UART buffer only holds ~5ms of input at our baud rate. Streaming needs every loop we can spare,
+  // otherwise pace the loop but keep draining input: the first frame of a stream arrives during the pause
+  if(!frameStream.IsActive())
+  {
+    const unsigned long pauseStart = millis();
+    while(millis() - pauseStart < LOOP_PAUSE)
     {
-        flushSerialInput();
-        LOGN("TIMEOUT");
-        return false;
+      serialRing.Fill(Serial);
     }
-    return true;
-}
-
-#ifndef FIXED_MSG_SIZE
-
-#else
-
-void ParseEffectArgs(byte effectId, size_t msgSize, EffectArgs& effectArgs)
-{
-    LOG("PARSE "); LOGN(msgSize);
-    Serial.flush();
-    effectArgs.ArgBuffer.Resize(msgSize);
-    ByteBuffer& argBuffer = effectArgs.ArgBuffer;
-
-    /*
-     *  Effect Ids are defined by our application. They are maintained in the EffectRegistry
-     *  We could optionally handle this parsing in the Effect Registry, but that would be overkill.
-     *  
-     *  ID 0: Color Correct Effect (float RBf), (char calibrateSymbol)
-     *  ID 1: Intensity Gradient Effect (byte intensityA, byte intensityB, byte dir)
-     *  ID 2: Party Effect (float bpmDelay), (byte animMode)
-     */
-    switch(effectId)
-    {
-        /* Color Correction */
-        case 0:
-        {
-            char arg = (char)Serial.read();
-            effectArgs.NumArgs++;
-            argBuffer.PutChar(arg);
-        }
-        break;
-
-        /* BPM */
-        case 1:
-        {
-            LOGN("BPM");
-            byte arg = Serial.read();
-            effectArgs.NumArgs++;
-            argBuffer.PutByte(arg);
-        }
-        break;
-
-        case 2:
-        case 3:
-        case 4:
-        case 5:
-        case 6:
-        case 7:
-        case 8:
-        case 9:
-        case 10:
-        case 11:
-        {
-            byte arg = Serial.read();
-            effectArgs.NumArgs++;
-            argBuffer.PutByte(arg);
-        }
-        break;
-        
-        case 49:
-        {
-            byte arg = Serial.read();
-            effectArgs.NumArgs++;
-            argBuffer.PutByte(arg);
-            Serial.flush();
-        }break;
-    }
-}
-#endif
-
-void abortReadTransmission()
-{
-    endReadTransmission();
-}
-
-void endReadTransmission()
-{
-    Serial.flush();
-    flushSerialInput();
+  }
 }
 
 void flushSerialInput()
@@ -0,0 +1,494 @@
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <EffectArgs.h>
+
+#include "LumetixClient.h"
+#include "TelemetryCsv.h"
+
+static const int REPLY_TIMEOUT_MS = 500;
+
+typedef std::chrono::steady_clock Clock;
+
+static double ElapsedSeconds(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void PrintUsage()
+{
+    fprintf(stderr,
+        "Usage: lumetix [-p port] [-b baud] command [args...]\n"
+        "\n"
+        "  ping                         Round trip to the device\n"
+        "  activate <id> [arg...]       Replace all effects with effect <id>\n"
+        "  args <id> <arg...>           Send arguments to an active effect\n"
+        "  push <id> <priority> [blend] Layer an effect on top of the stack\n"
+        "  remove <id>                  Remove a layered effect\n"
+        "  clear                        Remove all effects\n"
+        "  crossfade <ms>               Fade duration of activate\n"
+        "  stream [fps] [seconds] [chase|fade|noise]\n"
+        "                               Stream a test pattern, then report the fps achieved by the device\n"
+        "  stop                         Stop streaming, effects take over again\n"
+        "  stats                        Streaming statistics of the device\n"
+        "  profile                      Print the device's profiler report (PROFILE_MODE builds)\n"
+        "  bench [count]                Command latency and throughput\n"
+        "  telemetry [ms] [seconds] [record]\n"
+        "                               Turn on telemetry at one record per ms (100) and print it as CSV,\n"
+        "                               for seconds (0 until interrupted) and optionally a single record\n"
+        "\n"
+        "Effect arguments are typed, written little endian like ByteBuffer does:\n"
+        "  u8:<n> u16:<n> i16:<n> i32:<n> f:<float> c:<char>\n"
+        "\n"
+        "The port defaults to $LUMETIX_PORT, then /dev/ttyUSB0. The baud rate defaults to 115200.\n");
+}
+
+static bool ParseNumber(const char* text, long minValue, long maxValue, long& outValue)
+{
+    char* end = nullptr;
+    const long value = strtol(text, &end, 0);
+
+    if(!end || *end != '\0' || value < minValue || value > maxValue)
+    {
+        fprintf(stderr, "Invalid value '%s', expected %ld..%ld\n", text, minValue, maxValue);
+        return false;
+    }
+
+    outValue = value;
+    return true;
+}
+
+static bool ParseArgs(int argc, char** argv, ByteBuffer& outArgs)
+{
+    for(int i = 0; i < argc; i++)
+    {
+        const char* separator = strchr(argv[i], ':');
+        if(!separator)
+        {
+            fprintf(stderr, "Argument '%s' has no type, i.e u8:%s\n", argv[i], argv[i]);
+            return false;
+        }
+
+        const std::string type(argv[i], separator - argv[i]);
+        const char* text = separator + 1;
+        long value = 0;
+
+        if(type == "u8" && ParseNumber(text, 0, 255, value))
+        {
+            outArgs.PutByte((byte)value);
+        }
+        else if(type == "u16" && ParseNumber(text, 0, 65535, value))
+        {
+            outArgs.PutShort((int16_t)(uint16_t)value);
+        }
+        else if(type == "i16" && ParseNumber(text, -32768, 32767, value))
+        {
+            outArgs.PutShort((int16_t)value);
+        }
+        else if(type == "i32" && ParseNumber(text, INT32_MIN, INT32_MAX, value))
+        {
+            outArgs.PutInt((int32_t)value);
+        }
+        else if(type == "f")
+        {
+            outArgs.PutFloat((float)atof(text));
+        }
+        else if(type == "c" && strlen(text) == 1)
+        {
+            outArgs.PutChar(text[0]);
+        }
+        else
+        {
+            fprintf(stderr, "Invalid argument '%s'\n", argv[i]);
+            return false;
+        }
+    }
+
+    if(outArgs.GetNumWritten() > EFFECT_ARGS_MAX_BYTES)
+    {
+        fprintf(stderr, "Arguments exceed %d bytes\n", EFFECT_ARGS_MAX_BYTES);
+        return false;
+    }
+
+    return true;
+}
+
+static void PrintStreamStats(const DeviceStreamStats& stats)
+{
+    printf("Device: %.1f fps, %u received, %u committed, %u dropped, %u stale, %u rejected\n"
+        , stats.FpsX10 / 10.0, stats.NumReceived, stats.NumCommitted, stats.NumDropped, stats.NumStale, stats.NumRejected);
+}
+
+static void PrintProfileEntry(const DeviceProfileEntry& entry)
+{
+    static const char* const subsystemNames[] =
+    {
+        "Sampler",
+        "Panel",
+        "Composite"
+    };
+    static_assert(sizeof(subsystemNames) / sizeof(subsystemNames[0]) == static_cast<size_t>(EProfileSubsystem::MAX_VAL)
+                , "One name is expected per profiled subsystem");
+
+    if(entry.Entry == EProfileEntry::SUBSYSTEM && entry.Id < static_cast<uint8_t>(EProfileSubsystem::MAX_VAL))
+        printf("%-10s", subsystemNames[entry.Id]);
+    else
+        printf("Effect %-3u", entry.Id);
+
+    printf(" %5u %6u %6u %6u |", entry.Count, entry.Min, entry.Average, entry.Max);
+    for(int i = 0; i < PROFILE_HISTOGRAM_BINS; i++)
+    {
+        printf(" %u", entry.Histogram[i]);
+    }
+    printf("\n");
+}
+
+static void RenderPattern(const char* pattern, unsigned long frame, uint8_t* out)
+{
+    if(strcmp(pattern, "fade") == 0)
+    {
+        // Every LED changes, contiguously
+        const uint8_t level = (uint8_t)(127.5 + 127.5 * sin(frame * 0.1));
+        memset(out, level, FRAME_CODEC_FRAME_SIZE);
+    }
+    else if(strcmp(pattern, "noise") == 0)
+    {
+        // Worst case, nothing carries over from one frame to the next
+        for(int i = 0; i < FRAME_CODEC_FRAME_SIZE; i++)
+        {
+            out[i] = (uint8_t)rand();
+        }
+    }
+    else
+    {
+        // A lit LED with a short tail running around the panel, a handful of changes per frame
+        memset(out, 0, FRAME_CODEC_FRAME_SIZE);
+        for(int tail = 0; tail < 4; tail++)
+        {
+            out[(frame + FRAME_CODEC_FRAME_SIZE - tail) % FRAME_CODEC_FRAME_SIZE] = (uint8_t)(255 >> (2 * tail));
+        }
+    }
+}
+
+static int RunStream(LumetixClient& client, double fps, double seconds, const char* pattern)
+{
+    uint8_t frame[FRAME_CODEC_FRAME_SIZE];
+
+    // Every run is a new session: the device forgets the sequence numbers and statistics of the previous one,
+    // and the encoder starts over with a keyframe
+    if(!client.StopStream())
+    {
+        fprintf(stderr, "Write failed\n");
+        return 1;
+    }
+
+    const Clock::time_point start = Clock::now();
+    const unsigned long startBytes = client.GetNumBytesSent();
+    unsigned long numFrames = 0;
+
+    while(ElapsedSeconds(start) < seconds)
+    {
+        RenderPattern(pattern, numFrames, frame);
+        if(!client.SendFrame(frame))
+        {
+            fprintf(stderr, "Write failed\n");
+            return 1;
+        }
+        numFrames++;
+
+        if(fps > 0)
+        {
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(numFrames / fps)));
+        }
+    }
+
+    const double elapsed = ElapsedSeconds(start);
+    const unsigned long numBytes = client.GetNumBytesSent() - startBytes;
+    printf("Host: %lu frames in %.2fs, %.1f fps, %.1f bytes/frame, %lu keyframe requests\n"
+        , numFrames, elapsed, numFrames / elapsed, (double)numBytes / numFrames, client.GetNumResyncs());
+
+    // Let the device commit the last frames and close its fps window
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    DeviceStreamStats stats;
+    if(!client.QueryStreamStats(stats, REPLY_TIMEOUT_MS))
+    {
+        fprintf(stderr, "No stream statistics from the device\n");
+        return 1;
+    }
+
+    PrintStreamStats(stats);
+    return 0;
+}
+
+static volatile sig_atomic_t s_bInterrupted = 0;
+
+static void OnInterrupt(int)
+{
+    s_bInterrupted = 1;
+}
+
+static int RunTelemetry(LumetixClient& client, uint16_t intervalMs, double seconds, const char* recordName)
+{
+    if(!client.SetTelemetryInterval(intervalMs))
+        return 1;
+
+    signal(SIGINT, OnInterrupt);
+
+    TelemetryCsv csv(stdout, recordName);
+    const Clock::time_point start = Clock::now();
+
+    while(!s_bInterrupted && (seconds <= 0 || ElapsedSeconds(start) < seconds))
+    {
+        LumetixPacket packet;
+        if(client.Receive(packet, 100) && packet.Command == EProtocolCommand::TELEMETRY)
+        {
+            csv.Write(packet.Payload, packet.PayloadSize);
+            fflush(stdout);
+        }
+    }
+
+    // Telemetry costs the device bandwidth, leave it as it was before
+    client.SetTelemetryInterval(0);
+
+    fprintf(stderr, "%lu records, %lu malformed\n", csv.GetNumRecords(), csv.GetNumErrors());
+    return 0;
+}
+
+static int RunBench(LumetixClient& client, int count)
+{
+    // Latency: one command in flight at a time
+    std::vector<double> latencies;
+    latencies.reserve(count);
+
+    for(int i = 0; i < count; i++)
+    {
+        const uint8_t payload[] = { (uint8_t)i, (uint8_t)(i >> 8) };
+        const Clock::time_point start = Clock::now();
+
+        if(!client.Ping(payload, sizeof(payload), REPLY_TIMEOUT_MS))
+        {
+            fprintf(stderr, "Ping %d timed out\n", i);
+            return 1;
+        }
+
+        latencies.push_back(ElapsedSeconds(start) * 1000.0);
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    double total = 0;
+    for(double latency : latencies)
+    {
+        total += latency;
+    }
+
+    const size_t p99 = std::min(latencies.size() - 1, (size_t)(count * 0.99));
+    printf("Latency over %d round trips: min %.2fms, avg %.2fms, p99 %.2fms, max %.2fms\n"
+        , count, latencies.front(), total / count, latencies[p99], latencies.back());
+
+    // Throughput: keep a few commands in flight, few enough that the device's receive buffer never overflows
+    const int window = 4;
+    int numSent = 0;
+    int numReplies = 0;
+    const Clock::time_point start = Clock::now();
+
+    while(numReplies < count)
+    {
+        while(numSent < count && numSent - numReplies < window)
+        {
+            const uint8_t payload[] = { (uint8_t)numSent };
+            client.Send(EProtocolCommand::PING, payload, sizeof(payload));
+            numSent++;
+        }
+
+        LumetixPacket reply;
+        if(!client.WaitFor(EProtocolCommand::PONG, reply, REPLY_TIMEOUT_MS))
+        {
+            fprintf(stderr, "Lost replies: %d sent, %d received\n", numSent, numReplies);
+            return 1;
+        }
+        numReplies++;
+    }
+
+    const double elapsed = ElapsedSeconds(start);
+    printf("Throughput: %d commands in %.2fs, %.1f commands/s (%d in flight)\n", count, elapsed, count / elapsed, window);
+    printf("Decoder: %u packets, %u errors\n", client.GetDecoder().GetNumPackets(), client.GetDecoder().GetNumErrors());
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    const char* portPath = getenv("LUMETIX_PORT");
+    unsigned long baud = 115200;
+
+    int arg = 1;
+    for(; arg < argc && argv[arg][0] == '-'; arg++)
+    {
+        if(strcmp(argv[arg], "-p") == 0 && arg + 1 < argc)
+        {
+            portPath = argv[++arg];
+        }
+        else if(strcmp(argv[arg], "-b") == 0 && arg + 1 < argc)
+        {
+            baud = strtoul(argv[++arg], nullptr, 10);
+        }
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    if(arg >= argc)
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    const char* command = argv[arg++];
+    const int numArgs = argc - arg;
+    char** args = &argv[arg];
+
+    SerialPort port;
+    if(!port.Open(portPath ? portPath : "/dev/ttyUSB0", baud))
+        return 1;
+
+    LumetixClient client(port);
+    long value = 0;
+    long value2 = 0;
+    long value3 = 0;
+
+    if(strcmp(command, "ping") == 0)
+    {
+        const Clock::time_point start = Clock::now();
+        if(!client.Ping((const uint8_t*)"lumetix", 7, REPLY_TIMEOUT_MS))
+        {
+            fprintf(stderr, "No reply\n");
+            return 1;
+        }
+        printf("Pong in %.2fms\n", ElapsedSeconds(start) * 1000.0);
+        return 0;
+    }
+
+    if((strcmp(command, "activate") == 0 && numArgs >= 1) || (strcmp(command, "args") == 0 && numArgs >= 2))
+    {
+        ByteBuffer effectArgs = ByteBuffer::Allocate(EFFECT_ARGS_MAX_BYTES * 4);
+        if(!ParseNumber(args[0], 0, 255, value) || !ParseArgs(numArgs - 1, &args[1], effectArgs))
+            return 1;
+
+        const bool bSent = (strcmp(command, "activate") == 0)
+            ? client.ActivateEffect((uint8_t)value, &effectArgs)
+            : client.SetEffectArgs((uint8_t)value, effectArgs);
+        return bSent ? 0 : 1;
+    }
+
+    if(strcmp(command, "push") == 0 && numArgs >= 2)
+    {
+        value3 = 1; // EUpdateMode::ADD
+        if(!ParseNumber(args[0], 0, 255, value) || !ParseNumber(args[1], 0, 255, value2)
+            || (numArgs > 2 && !ParseNumber(args[2], 0, 255, value3)))
+            return 1;
+
+        return client.PushEffect((uint8_t)value, (uint8_t)value2, (uint8_t)value3) ? 0 : 1;
+    }
+
+    if(strcmp(command, "remove") == 0 && numArgs == 1)
+    {
+        if(!ParseNumber(args[0], 0, 255, value))
+            return 1;
+
+        return client.RemoveEffect((uint8_t)value) ? 0 : 1;
+    }
+
+    if(strcmp(command, "clear") == 0)
+    {
+        return client.ClearEffects() ? 0 : 1;
+    }
+
+    if(strcmp(command, "crossfade") == 0 && numArgs == 1)
+    {
+        if(!ParseNumber(args[0], 0, 65535, value))
+            return 1;
+
+        return client.SetCrossfade((uint16_t)value) ? 0 : 1;
+    }
+
+    if(strcmp(command, "stream") == 0)
+    {
+        const double fps = (numArgs > 0 ? atof(args[0]) : 30.0);
+        const double seconds = (numArgs > 1 ? atof(args[1]) : 5.0);
+        const char* pattern = (numArgs > 2 ? args[2] : "chase");
+        return RunStream(client, fps, seconds, pattern);
+    }
+
+    if(strcmp(command, "stop") == 0)
+    {
+        return client.StopStream() ? 0 : 1;
+    }
+
+    if(strcmp(command, "stats") == 0)
+    {
+        DeviceStreamStats stats;
+        if(!client.QueryStreamStats(stats, REPLY_TIMEOUT_MS))
+        {
+            fprintf(stderr, "No reply\n");
+            return 1;
+        }
+
+        PrintStreamStats(stats);
+        return 0;
+    }
+
+    if(strcmp(command, "profile") == 0)
+    {
+        std::vector<DeviceProfileEntry> entries;
+        if(!client.QueryProfile(entries, REPLY_TIMEOUT_MS))
+        {
+            fprintf(stderr, "No reply\n");
+            return 1;
+        }
+
+        if(entries.empty())
+        {
+            fprintf(stderr, "No profile data, the device is not built with PROFILE_MODE\n");
+            return 0;
+        }
+
+        printf("Entry      count    min    avg    max (us) | histogram\n");
+        for(const DeviceProfileEntry& entry : entries)
+        {
+            PrintProfileEntry(entry);
+        }
+        return 0;
+    }
+
+    if(strcmp(command, "bench") == 0)
+    {
+        if(numArgs > 0 && !ParseNumber(args[0], 1, 1000000, value))
+            return 1;
+
+        return RunBench(client, numArgs > 0 ? (int)value : 1000);
+    }
+
+    if(strcmp(command, "telemetry") == 0)
+    {
+        value = 100;
+        if(numArgs > 0 && !ParseNumber(args[0], 1, 65535, value))
+            return 1;
+
+        const double seconds = (numArgs > 1 ? atof(args[1]) : 0.0);
+        return RunTelemetry(client, (uint16_t)value, seconds, (numArgs > 2 ? args[2] : nullptr));
+    }
+
+    PrintUsage();
+    return 2;
+}
@@ -0,0 +1,237 @@
+#include "LumetixClient.h"
+
+#include <chrono>
+
+static long ElapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return (long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+LumetixClient::LumetixClient(SerialPort& port)
+    : m_Port(port)
+    , m_RxSize(0)
+    , m_RxPosition(0)
+    , m_NumBytesSent(0)
+    , m_NumResyncs(0)
+{
+}
+
+bool LumetixClient::Send(EProtocolCommand command, const uint8_t* payload, size_t payloadSize)
+{
+    uint8_t encoded[PROTOCOL_MAX_ENCODED + 1];
+
+    // Leading delimiter, the device drops whatever partial packet it may be holding
+    encoded[0] = 0;
+
+    const size_t numBytes = EncodePacket(command, payload, payloadSize, &encoded[1], sizeof(encoded) - 1);
+    if(numBytes == 0)
+        return false;
+
+    m_NumBytesSent += numBytes + 1;
+    return m_Port.Write(encoded, numBytes + 1);
+}
+
+bool LumetixClient::Decode(int timeoutMs)
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for(;;)
+    {
+        while(m_RxPosition < m_RxSize)
+        {
+            if(m_Decoder.Feed(m_RxBuffer[m_RxPosition++]))
+                return true;
+        }
+
+        const long remaining = timeoutMs - ElapsedMs(start);
+        const int numRead = m_Port.Read(m_RxBuffer, sizeof(m_RxBuffer), (remaining > 0 ? (int)remaining : 0));
+        if(numRead <= 0)
+            return false;
+
+        m_RxSize = (size_t)numRead;
+        m_RxPosition = 0;
+    }
+}
+
+bool LumetixClient::Receive(LumetixPacket& outPacket, int timeoutMs)
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    do
+    {
+        const long remaining = timeoutMs - ElapsedMs(start);
+        if(!Decode(remaining > 0 ? (int)remaining : 0))
+            return false;
+
+        // A delta was rejected, the next frame has to be a keyframe
+        if(m_Decoder.GetCommand() == EProtocolCommand::STREAM_RESYNC)
+        {
+            m_Encoder.RequestKeyframe();
+            m_NumResyncs++;
+            continue;
+        }
+
+        outPacket.Command = m_Decoder.GetCommand();
+        outPacket.PayloadSize = m_Decoder.GetPayloadSize();
+        memcpy(outPacket.Payload, m_Decoder.GetPayload(), outPacket.PayloadSize);
+        return true;
+    }
+    while(ElapsedMs(start) <= timeoutMs);
+
+    return false;
+}
+
+bool LumetixClient::WaitFor(EProtocolCommand command, LumetixPacket& outPacket, int timeoutMs)
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for(long remaining = timeoutMs; remaining >= 0; remaining = timeoutMs - ElapsedMs(start))
+    {
+        if(!Receive(outPacket, (int)remaining))
+            return false;
+
+        if(outPacket.Command == command)
+            return true;
+    }
+
+    return false;
+}
+
+bool LumetixClient::Ping(const uint8_t* data, size_t size, int timeoutMs)
+{
+    if(!Send(EProtocolCommand::PING, data, size))
+        return false;
+
+    LumetixPacket reply;
+    if(!WaitFor(EProtocolCommand::PONG, reply, timeoutMs))
+        return false;
+
+    return reply.PayloadSize == size && memcmp(reply.Payload, data, size) == 0;
+}
+
+bool LumetixClient::SendEffectArgs(EProtocolCommand command, uint8_t effectId, const ByteBuffer* args)
+{
+    uint8_t payload[PROTOCOL_MAX_PAYLOAD];
+    ByteWriter writer(payload, sizeof(payload));
+
+    writer.PutByte(effectId);
+    if(args)
+    {
+        writer.PutBytes(args->GetData(), args->GetNumWritten());
+    }
+
+    return writer.IsValid() && Send(command, payload, writer.GetPosition());
+}
+
+bool LumetixClient::ActivateEffect(uint8_t effectId, const ByteBuffer* args)
+{
+    return SendEffectArgs(EProtocolCommand::ACTIVATE_EFFECT, effectId, args);
+}
+
+bool LumetixClient::SetEffectArgs(uint8_t effectId, const ByteBuffer& args)
+{
+    return SendEffectArgs(EProtocolCommand::SET_EFFECT_ARGS, effectId, &args);
+}
+
+bool LumetixClient::PushEffect(uint8_t effectId, uint8_t priority, uint8_t blendMode)
+{
+    const uint8_t payload[] = { effectId, priority, blendMode };
+    return Send(EProtocolCommand::PUSH_EFFECT, payload, sizeof(payload));
+}
+
+bool LumetixClient::RemoveEffect(uint8_t effectId)
+{
+    return Send(EProtocolCommand::REMOVE_EFFECT, &effectId, 1);
+}
+
+bool LumetixClient::ClearEffects()
+{
+    return Send(EProtocolCommand::CLEAR_EFFECTS);
+}
+
+bool LumetixClient::SetCrossfade(uint16_t durationMs)
+{
+    uint8_t payload[sizeof(uint16_t)];
+    StoreLE(payload, durationMs);
+    return Send(EProtocolCommand::SET_CROSSFADE, payload, sizeof(payload));
+}
+
+bool LumetixClient::SendFrame(const uint8_t* frame)
+{
+    // Pick up keyframe requests that arrived since the last frame, without waiting for any
+    LumetixPacket packet;
+    while(Receive(packet, 0))
+    {
+    }
+
+    uint8_t payload[PROTOCOL_MAX_PAYLOAD];
+    EProtocolCommand command;
+
+    const size_t payloadSize = m_Encoder.Encode(frame, command, payload, sizeof(payload));
+    return payloadSize > 0 && Send(command, payload, payloadSize);
+}
+
+bool LumetixClient::StopStream()
+{
+    m_Encoder.Reset();
+    return Send(EProtocolCommand::STREAM_STOP);
+}
+
+bool LumetixClient::QueryStreamStats(DeviceStreamStats& outStats, int timeoutMs)
+{
+    if(!Send(EProtocolCommand::STREAM_STATS))
+        return false;
+
+    LumetixPacket reply;
+    if(!WaitFor(EProtocolCommand::STREAM_STATS, reply, timeoutMs))
+        return false;
+
+    ByteReader reader(reply.Payload, reply.PayloadSize);
+    outStats.FpsX10         = reader.GetLE<uint16_t>();
+    outStats.NumReceived    = reader.GetLE<uint16_t>();
+    outStats.NumCommitted   = reader.GetLE<uint16_t>();
+    outStats.NumStale       = reader.GetLE<uint16_t>();
+    outStats.NumDropped     = reader.GetLE<uint16_t>();
+    outStats.NumRejected    = reader.GetLE<uint16_t>();
+    return reader.IsValid();
+}
+
+bool LumetixClient::SetTelemetryInterval(uint16_t intervalMs)
+{
+    uint8_t payload[sizeof(uint16_t)];
+    StoreLE(payload, intervalMs);
+    return Send(EProtocolCommand::TELEMETRY_CONFIG, payload, sizeof(payload));
+}
+
+bool LumetixClient::QueryProfile(std::vector<DeviceProfileEntry>& outEntries, int timeoutMs)
+{
+    outEntries.clear();
+
+    if(!Send(EProtocolCommand::PROFILE_QUERY))
+        return false;
+
+    LumetixPacket reply;
+    while(WaitFor(EProtocolCommand::PROFILE_REPORT, reply, timeoutMs))
+    {
+        // An empty packet ends the report
+        if(reply.PayloadSize == 0)
+            return true;
+
+        DeviceProfileEntry entry;
+        ByteReader reader(reply.Payload, reply.PayloadSize);
+        entry.Entry     = static_cast<EProfileEntry>(reader.GetByte());
+        entry.Id        = reader.GetByte();
+        entry.Count     = reader.GetLE<uint16_t>();
+        entry.Min       = reader.GetLE<uint32_t>();
+        entry.Average   = reader.GetLE<uint32_t>();
+        entry.Max       = reader.GetLE<uint32_t>();
+        reader.GetArrayLE(entry.Histogram, PROFILE_HISTOGRAM_BINS);
+
+        if(reader.IsValid())
+        {
+            outEntries.push_back(entry);
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,108 @@
+#ifndef LUMETIX_CLIENT_H
+#define LUMETIX_CLIENT_H
+
+#include <vector>
+
+#include <ProtocolFraming.h>
+#include <FrameCodec.h>
+#include <ByteBuffer.h>
+#include <Profiler.h>
+
+#include "SerialPort.h"
+
+struct LumetixPacket
+{
+    EProtocolCommand Command;
+    uint8_t Payload[PROTOCOL_MAX_PAYLOAD];
+    size_t PayloadSize;
+};
+
+/* Reply to STREAM_STATS, see FrameStreamStats */
+struct DeviceStreamStats
+{
+    uint16_t FpsX10;
+    uint16_t NumReceived;
+    uint16_t NumCommitted;
+    uint16_t NumStale;
+    uint16_t NumDropped;
+    uint16_t NumRejected;
+};
+
+/* One PROFILE_REPORT entry, durations in us. See ProfileStats */
+struct DeviceProfileEntry
+{
+    EProfileEntry Entry;
+    uint8_t Id;
+    uint16_t Count;
+    uint32_t Min;
+    uint32_t Average;
+    uint32_t Max;
+    uint16_t Histogram[PROFILE_HISTOGRAM_BINS];
+};
+
+/*  Lumetix Client
+*
+*   Host end of the Lumetix protocol (see ProtocolFraming.h), over any serial port. Packets are built and
+*   parsed with the same framing, codec and ByteBuffer sources as the firmware, so both ends can not drift apart.
+*
+*   Commands are fire and forget, like on the device. Replies are read with Receive/WaitFor, which also
+*   handle the device's keyframe requests for SendFrame behind the scenes.
+*/
+class LumetixClient
+{
+public:
+    LumetixClient(SerialPort& port);
+
+    bool Send(EProtocolCommand command, const uint8_t* payload = nullptr, size_t payloadSize = 0);
+
+    /* Returns true once a packet arrived within timeoutMs. Anything that is not a valid packet is dropped */
+    bool Receive(LumetixPacket& outPacket, int timeoutMs);
+
+    /* Waits for a packet of the given command, packets of other commands are dropped */
+    bool WaitFor(EProtocolCommand command, LumetixPacket& outPacket, int timeoutMs);
+
+    /* Round trip, the device echoes the payload back */
+    bool Ping(const uint8_t* data, size_t size, int timeoutMs);
+
+    /* Effect commands. Arguments are the bytes written to the buffer so far */
+    bool ActivateEffect(uint8_t effectId, const ByteBuffer* args = nullptr);
+    bool SetEffectArgs(uint8_t effectId, const ByteBuffer& args);
+    bool PushEffect(uint8_t effectId, uint8_t priority, uint8_t blendMode);
+    bool RemoveEffect(uint8_t effectId);
+    bool ClearEffects();
+    bool SetCrossfade(uint16_t durationMs);
+
+    /* Streaming, frames are FRAME_CODEC_FRAME_SIZE bytes laid out as a PanelFrame */
+    bool SendFrame(const uint8_t* frame);
+    bool StopStream();
+    bool QueryStreamStats(DeviceStreamStats& outStats, int timeoutMs);
+
+    /* Rate of the device's periodic telemetry records, 0 turns telemetry off. Records arrive as TELEMETRY packets */
+    bool SetTelemetryInterval(uint16_t intervalMs);
+
+    /*  Collects the profiler report, which also resets the device's profiler. Devices built without PROFILE_MODE
+    *   reply with an empty report. Returns false if the report did not complete, timeoutMs applies per entry.
+    */
+    bool QueryProfile(std::vector<DeviceProfileEntry>& outEntries, int timeoutMs);
+
+    inline const PacketDecoder& GetDecoder() const { return m_Decoder; }
+    inline unsigned long GetNumBytesSent() const { return m_NumBytesSent; }
+    inline unsigned long GetNumResyncs() const { return m_NumResyncs; }
+private:
+    bool SendEffectArgs(EProtocolCommand command, uint8_t effectId, const ByteBuffer* args);
+
+    /* Feeds buffered bytes to the decoder until a packet completes. Reads more only if timeoutMs allows */
+    bool Decode(int timeoutMs);
+private:
+    SerialPort& m_Port;
+    PacketDecoder m_Decoder;
+    FrameEncoder m_Encoder;
+
+    uint8_t m_RxBuffer[256];
+    size_t m_RxSize;
+    size_t m_RxPosition;
+
+    unsigned long m_NumBytesSent;
+    unsigned long m_NumResyncs;
+};
+#endif // !LUMETIX_CLIENT_H
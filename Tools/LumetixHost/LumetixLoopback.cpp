@@ -0,0 +1,331 @@
+#include <chrono>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <Arduino.h>
+#include <Wire.h>
+
+/*  Lumetix Loopback
+*
+*   Runs the firmware sketch on the host, with simulated TLC59116 drivers and ISL29125 sensor on a simulated
+*   I2C bus, and its serial port on a pty. Point any client (i.e the lumetix CLI) at the printed pty to
+*   exercise the whole protocol and effect pipeline without hardware.
+*
+*   Serial reception is paced at the sketch's baud rate and I2C transactions take as long as on the real bus,
+*   so frame rates and dropped frames are representative of the device. Timings of the firmware code itself
+*   are not: the host is much faster than an AVR.
+*/
+
+// The sketch is built as is. Arduino generates prototypes for sketch functions, these are the ones used before their definition
+void flushSerialInput();
+
+#ifndef LOOPBACK_SKETCH
+    #define LOOPBACK_SKETCH "../../Sketches/NAJI_FaceScrubber_LightSense_Curve/NAJI_FaceScrubber_LightSense_Curve.ino"
+#endif
+#include LOOPBACK_SKETCH
+
+#define TLC_REGISTER_MASK   0x1F
+#define TLC_PWM0            0x02
+#define TLC_RESET_BYTE_0    0xA5
+#define TLC_RESET_BYTE_1    0x5A
+
+/* Conversion time of a single color, RGB mode converts all three in sequence */
+#define ISL_CONVERSION_TIME 100
+
+/* Panel driver: a plain register file, PWM registers can be inspected to see what the panel shows */
+class TlcModel : public I2CDevice
+{
+public:
+    TlcModel(uint8_t address)
+        : I2CDevice(address, TLC_REGISTER_MASK)
+    {
+    }
+
+    void Reset() { memset(Registers, 0, sizeof(Registers)); }
+    inline const uint8_t* GetPwm() const { return &Registers[TLC_PWM0]; }
+};
+
+/* AllCall writes reach every driver, the software reset address resets them all */
+class TlcBusModel : public I2CDevice
+{
+public:
+    TlcBusModel(uint8_t address, TlcModel* drivers, size_t numDrivers, bool bReset)
+        : I2CDevice(address, TLC_REGISTER_MASK)
+        , m_Drivers(drivers)
+        , m_NumDrivers(numDrivers)
+        , m_bReset(bReset)
+    {
+    }
+
+    virtual void OnWrite(const uint8_t* data, size_t size) override
+    {
+        for(size_t i = 0; i < m_NumDrivers; i++)
+        {
+            if(!m_bReset)
+            {
+                m_Drivers[i].OnWrite(data, size);
+            }
+            else if(size == 2 && data[0] == TLC_RESET_BYTE_0 && data[1] == TLC_RESET_BYTE_1)
+            {
+                m_Drivers[i].Reset();
+            }
+        }
+    }
+private:
+    TlcModel* m_Drivers;
+    size_t m_NumDrivers;
+    bool m_bReset;
+};
+
+/* Light sensor reporting a constant light, at the real conversion rate */
+class IslModel : public I2CDevice
+{
+public:
+    IslModel(uint16_t red, uint16_t green, uint16_t blue)
+        : I2CDevice(ISL_I2C_ADDR, 0x1F)
+        , m_LastConversion(0)
+    {
+        Reset();
+        SetLight(red, green, blue);
+    }
+
+    void SetLight(uint16_t red, uint16_t green, uint16_t blue)
+    {
+        Registers[RED_L] = red & 0xFF;      Registers[RED_H] = red >> 8;
+        Registers[GREEN_L] = green & 0xFF;  Registers[GREEN_H] = green >> 8;
+        Registers[BLUE_L] = blue & 0xFF;    Registers[BLUE_H] = blue >> 8;
+    }
+
+    virtual void OnWrite(const uint8_t* data, size_t size) override
+    {
+        if(size == 2 && data[0] == DEVICE_ID && data[1] == 0x46)
+        {
+            Reset();
+            return;
+        }
+
+        I2CDevice::OnWrite(data, size);
+    }
+
+    virtual uint8_t OnRead() override
+    {
+        if(m_Pointer == STATUS)
+        {
+            // Reading the status clears the interrupt flag, until the next conversion completes
+            const unsigned long now = millis();
+            if(now - m_LastConversion >= 3 * ISL_CONVERSION_TIME)
+            {
+                m_LastConversion = now;
+                Registers[STATUS] |= FLAG_INT | FLAG_CONV_DONE;
+            }
+
+            const uint8_t status = I2CDevice::OnRead();
+            Registers[STATUS] &= ~FLAG_INT;
+            return status;
+        }
+
+        return I2CDevice::OnRead();
+    }
+private:
+    void Reset()
+    {
+        for(uint8_t reg = CONFIG_1; reg <= STATUS; reg++)
+        {
+            Registers[reg] = 0;
+        }
+        Registers[DEVICE_ID] = 0x7D;
+    }
+private:
+    unsigned long m_LastConversion;
+};
+
+static volatile sig_atomic_t s_bRunning = 1;
+
+static void OnSignal(int)
+{
+    s_bRunning = 0;
+}
+
+static void PrintUsage()
+{
+    fprintf(stderr,
+        "Usage: lumetix-loopback [--link path] [--rgb r,g,b] [--report seconds] [--fast-bus] [--unpaced]\n"
+        "\n"
+        "  --link path      Also expose the pty as path (a symlink)\n"
+        "  --rgb r,g,b      Raw sensor readings, defaults to 1200,1500,1300\n"
+        "  --report s       Print loop and bus statistics every s seconds, defaults to 5. 0 disables\n"
+        "  --fast-bus       I2C transactions complete instantly instead of at the bus clock\n"
+        "  --unpaced        Serial bytes arrive instantly instead of at the sketch's baud rate\n");
+}
+
+static int OpenPty(char* outName, size_t nameCapacity, int& outSlave)
+{
+    const int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if(master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    {
+        perror("posix_openpt");
+        return -1;
+    }
+
+    const char* name = ptsname(master);
+    if(!name)
+    {
+        perror("ptsname");
+        return -1;
+    }
+    snprintf(outName, nameCapacity, "%s", name);
+
+    // Held open so that the master does not hang up between clients. Raw, or the line discipline would echo and mangle bytes
+    outSlave = open(outName, O_RDWR | O_NOCTTY);
+    termios tty;
+    if(outSlave < 0 || tcgetattr(outSlave, &tty) != 0)
+    {
+        perror("pty");
+        return -1;
+    }
+    cfmakeraw(&tty);
+    tcsetattr(outSlave, TCSANOW, &tty);
+
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+    return master;
+}
+
+int main(int argc, char** argv)
+{
+    const char* linkPath = nullptr;
+    unsigned int red = 1200, green = 1500, blue = 1300;
+    double reportInterval = 5.0;
+    bool bRealtimeBus = true;
+    bool bPaced = true;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--link") == 0 && i + 1 < argc)
+        {
+            linkPath = argv[++i];
+        }
+        else if(strcmp(argv[i], "--rgb") == 0 && i + 1 < argc && sscanf(argv[i + 1], "%u,%u,%u", &red, &green, &blue) == 3)
+        {
+            i++;
+        }
+        else if(strcmp(argv[i], "--report") == 0 && i + 1 < argc)
+        {
+            reportInterval = atof(argv[++i]);
+        }
+        else if(strcmp(argv[i], "--fast-bus") == 0)
+        {
+            bRealtimeBus = false;
+        }
+        else if(strcmp(argv[i], "--unpaced") == 0)
+        {
+            bPaced = false;
+        }
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    char ptyName[128];
+    int slave = -1;
+    const int master = OpenPty(ptyName, sizeof(ptyName), slave);
+    if(master < 0)
+        return 1;
+
+    if(linkPath)
+    {
+        unlink(linkPath);
+        if(symlink(ptyName, linkPath) != 0)
+        {
+            perror("symlink");
+            return 1;
+        }
+    }
+
+    // Four panels, as LedPanel expects. Addresses as found by TLC59116Manager::scan
+    TlcModel drivers[] = { TlcModel(0x60), TlcModel(0x61), TlcModel(0x62), TlcModel(0x63) };
+    const size_t numDrivers = sizeof(drivers) / sizeof(drivers[0]);
+    TlcBusModel allCall(TLC59116_Unmanaged::AllCall_Addr, drivers, numDrivers, false);
+    TlcBusModel reset(TLC59116_Unmanaged::Reset_Addr, drivers, numDrivers, true);
+    IslModel sensor((uint16_t)red, (uint16_t)green, (uint16_t)blue);
+
+    for(size_t i = 0; i < numDrivers; i++)
+    {
+        Wire.Attach(drivers[i]);
+    }
+    Wire.Attach(allCall);
+    Wire.Attach(reset);
+    Wire.Attach(sensor);
+
+    Serial.Attach(master);
+
+    signal(SIGINT, OnSignal);
+    signal(SIGTERM, OnSignal);
+
+    fprintf(stderr, "Loopback device on %s%s%s\n", ptyName, (linkPath ? " -> " : ""), (linkPath ? linkPath : ""));
+
+    setup();
+
+    // The sketch configured the bus through TWBR, and its baud rate through Serial.begin
+    Wire.setClock(F_CPU / (16 + 2 * TWBR));
+    Wire.SetRealtime(bRealtimeBus);
+    if(!bPaced)
+    {
+        Serial.begin(0);
+    }
+
+    unsigned long numLoops = 0;
+    unsigned long loopTime = 0;
+    unsigned long maxLoopTime = 0;
+    unsigned long lastReport = millis();
+    unsigned long lastBusBytes = Wire.GetNumBytes();
+    unsigned long lastBusTime = Wire.GetBusTime();
+
+    while(s_bRunning)
+    {
+        const unsigned long start = micros();
+        loop();
+        const unsigned long duration = micros() - start;
+
+        numLoops++;
+        loopTime += duration;
+        maxLoopTime = (duration > maxLoopTime ? duration : maxLoopTime);
+
+        const unsigned long now = millis();
+        const unsigned long elapsed = now - lastReport;
+        if(reportInterval > 0 && elapsed >= reportInterval * 1000)
+        {
+            const unsigned long busBytes = Wire.GetNumBytes() - lastBusBytes;
+            const unsigned long busTime = Wire.GetBusTime() - lastBusTime;
+
+            fprintf(stderr, "%.1f loops/s, loop avg %luus max %luus | I2C %.1f kB/s, %.1f%% busy | serial overruns %lu | TOP[0..3] %u %u %u %u\n"
+                , numLoops * 1000.0 / elapsed, loopTime / numLoops, maxLoopTime
+                , busBytes / (double)elapsed, busTime / (elapsed * 10.0), Serial.GetNumOverruns()
+                , drivers[0].GetPwm()[0], drivers[0].GetPwm()[1], drivers[0].GetPwm()[2], drivers[0].GetPwm()[3]);
+
+            numLoops = 0;
+            loopTime = 0;
+            maxLoopTime = 0;
+            lastReport = now;
+            lastBusBytes = Wire.GetNumBytes();
+            lastBusTime = Wire.GetBusTime();
+        }
+    }
+
+    if(linkPath)
+    {
+        unlink(linkPath);
+    }
+
+    close(slave);
+    close(master);
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include "SerialPort.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+static bool ToSpeed(unsigned long baud, speed_t& outSpeed)
+{
+    switch(baud)
+    {
+        case 9600:      outSpeed = B9600;   return true;
+        case 19200:     outSpeed = B19200;  return true;
+        case 38400:     outSpeed = B38400;  return true;
+        case 57600:     outSpeed = B57600;  return true;
+        case 115200:    outSpeed = B115200; return true;
+        case 230400:    outSpeed = B230400; return true;
+        case 460800:    outSpeed = B460800; return true;
+        case 500000:    outSpeed = B500000; return true;
+        case 1000000:   outSpeed = B1000000; return true;
+        default:        return false;
+    }
+}
+
+SerialPort::SerialPort()
+    : m_Fd(-1)
+{
+}
+
+SerialPort::~SerialPort()
+{
+    Close();
+}
+
+bool SerialPort::Open(const char* path, unsigned long baud)
+{
+    Close();
+
+    speed_t speed;
+    if(!ToSpeed(baud, speed))
+    {
+        fprintf(stderr, "Unsupported baud rate %lu\n", baud);
+        return false;
+    }
+
+    m_Fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if(m_Fd < 0)
+    {
+        fprintf(stderr, "Can not open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+
+    termios tty;
+    if(tcgetattr(m_Fd, &tty) != 0)
+    {
+        fprintf(stderr, "%s is not a serial port: %s\n", path, strerror(errno));
+        Close();
+        return false;
+    }
+
+    cfmakeraw(&tty);
+    tty.c_cflag |= CLOCAL | CREAD;
+    tty.c_cflag &= ~(CSTOPB | CRTSCTS);
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+    cfsetispeed(&tty, speed);
+    cfsetospeed(&tty, speed);
+
+    if(tcsetattr(m_Fd, TCSANOW, &tty) != 0)
+    {
+        fprintf(stderr, "Can not configure %s: %s\n", path, strerror(errno));
+        Close();
+        return false;
+    }
+
+    // Opening the port resets most boards, anything already buffered predates the reset
+    tcflush(m_Fd, TCIOFLUSH);
+    return true;
+}
+
+void SerialPort::Close()
+{
+    if(m_Fd >= 0)
+    {
+        close(m_Fd);
+        m_Fd = -1;
+    }
+}
+
+bool SerialPort::Write(const uint8_t* data, size_t size)
+{
+    while(size > 0)
+    {
+        const ssize_t result = write(m_Fd, data, size);
+        if(result < 0)
+        {
+            if(errno != EAGAIN && errno != EINTR)
+                return false;
+
+            // Output queue is full, wait for room
+            pollfd pfd = { m_Fd, POLLOUT, 0 };
+            poll(&pfd, 1, 100);
+            continue;
+        }
+
+        data += result;
+        size -= (size_t)result;
+    }
+
+    return true;
+}
+
+int SerialPort::Read(uint8_t* data, size_t capacity, int timeoutMs)
+{
+    pollfd pfd = { m_Fd, POLLIN, 0 };
+
+    const int ready = poll(&pfd, 1, timeoutMs);
+    if(ready < 0)
+        return (errno == EINTR ? 0 : -1);
+
+    if(ready == 0)
+        return 0;
+
+    const ssize_t result = read(m_Fd, data, capacity);
+    if(result < 0)
+        return (errno == EAGAIN || errno == EINTR ? 0 : -1);
+
+    // Readable without any data, the other end hung up
+    if(result == 0)
+        return -1;
+
+    return (int)result;
+}
+
+void SerialPort::Drain()
+{
+    tcdrain(m_Fd);
+}
+
+void SerialPort::FlushInput()
+{
+    tcflush(m_Fd, TCIFLUSH);
+}
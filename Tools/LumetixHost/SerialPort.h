@@ -0,0 +1,38 @@
+#ifndef LUMETIX_HOST_SERIAL_PORT_H
+#define LUMETIX_HOST_SERIAL_PORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*  Serial Port
+*
+*   Raw 8N1 serial port on Linux, for both real ttys (i.e /dev/ttyUSB0) and ptys (i.e the loopback device).
+*   Baud rates are ignored by ptys.
+*/
+class SerialPort
+{
+public:
+    SerialPort();
+    ~SerialPort();
+
+    SerialPort(const SerialPort&) = delete;
+    SerialPort& operator=(const SerialPort&) = delete;
+
+    bool Open(const char* path, unsigned long baud);
+    void Close();
+    inline bool IsOpen() const { return m_Fd >= 0; }
+
+    bool Write(const uint8_t* data, size_t size);
+
+    /* Waits up to timeoutMs for data, then reads whatever is available. Returns the number of bytes read, -1 on error */
+    int Read(uint8_t* data, size_t capacity, int timeoutMs);
+
+    /* Waits until everything written was transmitted */
+    void Drain();
+
+    /* Discards anything received so far */
+    void FlushInput();
+private:
+    int m_Fd;
+};
+#endif // !LUMETIX_HOST_SERIAL_PORT_H
@@ -0,0 +1,84 @@
+#include "TelemetryCsv.h"
+
+#include <string.h>
+
+#include <ByteCodec.h>
+
+TelemetryCsv::TelemetryCsv(FILE* out, const char* recordName)
+    : m_Out(out)
+    , m_RecordName(recordName)
+    , m_Time(0)
+    , m_LastStamp(0)
+    , m_bHasTime(false)
+    , m_NumRecords(0)
+    , m_NumErrors(0)
+{
+    memset(m_bHeaderWritten, 0, sizeof(m_bHeaderWritten));
+}
+
+void TelemetryCsv::WriteHeader(const TelemetryRecordInfo& info)
+{
+    fprintf(m_Out, "time_ms,record");
+    for(uint8_t i = 0; i < info.NumFields; i++)
+    {
+        fprintf(m_Out, ",%s", info.Fields[i].Name);
+    }
+    fprintf(m_Out, "\n");
+}
+
+bool TelemetryCsv::Write(const uint8_t* payload, size_t payloadSize)
+{
+    ByteReader reader(payload, payloadSize);
+    const uint8_t recordId = reader.GetByte();
+    const uint16_t stamp = reader.GetLE<uint16_t>();
+
+    const TelemetryRecordInfo* info = GetTelemetryRecordInfo(recordId);
+    if(!reader.IsValid() || !info)
+    {
+        m_NumErrors++;
+        return false;
+    }
+
+    // Records are sent in order, a smaller stamp means millis() wrapped its low 16 bits
+    m_Time += (m_bHasTime ? (uint16_t)(stamp - m_LastStamp) : stamp);
+    m_LastStamp = stamp;
+    m_bHasTime = true;
+
+    size_t numBytes = 0;
+    for(uint8_t i = 0; i < info->NumFields; i++)
+    {
+        numBytes += GetTelemetryFieldSize(info->Fields[i].Type);
+    }
+
+    if(reader.GetRemaining() != numBytes)
+    {
+        m_NumErrors++;
+        return false;
+    }
+
+    m_NumRecords++;
+
+    if(m_RecordName && strcmp(m_RecordName, info->Name) != 0)
+        return true;
+
+    if(!m_bHeaderWritten[recordId])
+    {
+        WriteHeader(*info);
+        m_bHeaderWritten[recordId] = true;
+    }
+
+    fprintf(m_Out, "%lu,%s", m_Time, info->Name);
+    for(uint8_t i = 0; i < info->NumFields; i++)
+    {
+        switch(info->Fields[i].Type)
+        {
+            case ETelemetryField::U8:       fprintf(m_Out, ",%u", reader.GetByte()); break;
+            case ETelemetryField::U16:      fprintf(m_Out, ",%u", reader.GetLE<uint16_t>()); break;
+            case ETelemetryField::Q8_8:     fprintf(m_Out, ",%.4f", FromQ8_8(reader.GetLE<int16_t>())); break;
+            case ETelemetryField::UQ0_16:   fprintf(m_Out, ",%.5f", FromUQ0_16(reader.GetLE<uint16_t>())); break;
+            default: break;
+        }
+    }
+    fprintf(m_Out, "\n");
+    return true;
+}
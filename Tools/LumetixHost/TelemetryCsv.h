@@ -0,0 +1,43 @@
+#ifndef TELEMETRY_CSV_H
+#define TELEMETRY_CSV_H
+
+#include <stdio.h>
+
+#include <TelemetrySchema.h>
+
+/*  Telemetry CSV
+*
+*   Turns TELEMETRY payloads into CSV rows, with the record schema shared with the firmware:
+*
+*       time_ms,record,<fields...>
+*
+*   A header row is written the first time each record shows up. With a record filter, the output is a
+*   single table. The device's 16 bit timestamps are unwrapped into a running ms count.
+*/
+class TelemetryCsv
+{
+public:
+    /* recordName, if any, only writes records of that name */
+    TelemetryCsv(FILE* out, const char* recordName = nullptr);
+
+    /* Returns false for unknown or malformed records, which are skipped */
+    bool Write(const uint8_t* payload, size_t payloadSize);
+
+    inline unsigned long GetNumRecords() const { return m_NumRecords; }
+    inline unsigned long GetNumErrors() const { return m_NumErrors; }
+private:
+    void WriteHeader(const TelemetryRecordInfo& info);
+private:
+    FILE* m_Out;
+    const char* m_RecordName;
+
+    unsigned long m_Time;
+    uint16_t m_LastStamp;
+    bool m_bHasTime;
+
+    bool m_bHeaderWritten[static_cast<int>(ETelemetryRecord::MAX_VAL)];
+
+    unsigned long m_NumRecords;
+    unsigned long m_NumErrors;
+};
+#endif // !TELEMETRY_CSV_H
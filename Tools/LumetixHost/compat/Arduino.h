@@ -0,0 +1,109 @@
+#ifndef LUMETIX_HOST_ARDUINO_H
+#define LUMETIX_HOST_ARDUINO_H
+
+/*  Host Arduino Compatibility
+*
+*   The subset of the Arduino core used by the Lumetix libraries and their drivers, so that the firmware
+*   core builds and runs on Linux (see LumetixLoopback.cpp). This is not a general purpose emulation:
+*   time is wall clock time, interrupts do not exist and pins do nothing.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define F_CPU 16000000UL
+
+#define HEX 16
+#define DEC 10
+#define OCT 8
+#define BIN 2
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define digitalPinToInterrupt(pin) (pin)
+#define interrupts()
+#define noInterrupts()
+
+class __FlashStringHelper;
+#define F(str) (reinterpret_cast<const __FlashStringHelper*>(str))
+#define PSTR(str) (str)
+
+template<typename A, typename B>
+inline auto min(const A& a, const B& b) -> decltype(a < b ? a : b) { return (b < a ? b : a); }
+
+template<typename A, typename B>
+inline auto max(const A& a, const B& b) -> decltype(a < b ? b : a) { return (a < b ? b : a); }
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+/* I2C bit rate register, only written by the TLC59116 driver */
+extern uint8_t TWBR;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+long random(long howBig);
+long random(long howSmall, long howBig);
+void randomSeed(unsigned long seed);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t interrupt, void (*isr)(), int mode);
+void detachInterrupt(uint8_t interrupt);
+
+class Print
+{
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t b) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str) { return (str ? write((const uint8_t*)str, strlen(str)) : 0); }
+
+    size_t print(const __FlashStringHelper* str);
+    size_t print(const char* str);
+    size_t print(char c);
+    size_t print(unsigned char value, int base = DEC);
+    size_t print(int value, int base = DEC);
+    size_t print(unsigned int value, int base = DEC);
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println();
+    template<typename T> size_t println(T value) { return print(value) + println(); }
+    template<typename T> size_t println(T value, int format) { return print(value, format) + println(); }
+
+    virtual void flush() {}
+private:
+    size_t PrintNumber(unsigned long value, int base);
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+#include "HardwareSerial.h"
+#endif // !LUMETIX_HOST_ARDUINO_H
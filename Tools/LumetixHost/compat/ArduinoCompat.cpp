@@ -0,0 +1,449 @@
+#include <chrono>
+#include <thread>
+#include <random>
+
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include "Arduino.h"
+#include "Wire.h"
+
+uint8_t TWBR = 0;
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+static std::chrono::steady_clock::time_point s_StartTime = std::chrono::steady_clock::now();
+static std::minstd_rand s_Random;
+
+unsigned long millis()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - s_StartTime).count();
+}
+
+unsigned long micros()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_StartTime).count();
+}
+
+void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+long random(long howBig)
+{
+    return (howBig > 0 ? (long)(s_Random() % (unsigned long)howBig) : 0);
+}
+
+long random(long howSmall, long howBig)
+{
+    return (howSmall < howBig ? howSmall + random(howBig - howSmall) : howSmall);
+}
+
+void randomSeed(unsigned long seed)
+{
+    s_Random.seed(seed);
+}
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return HIGH; }
+void attachInterrupt(uint8_t, void (*)(), int) {}
+void detachInterrupt(uint8_t) {}
+
+/*
+*   Print
+*/
+size_t Print::write(const uint8_t* buffer, size_t size)
+{
+    size_t numWritten = 0;
+    while(size-- > 0)
+    {
+        numWritten += write(*buffer++);
+    }
+    return numWritten;
+}
+
+size_t Print::print(const __FlashStringHelper* str)
+{
+    return print(reinterpret_cast<const char*>(str));
+}
+
+size_t Print::print(const char* str)
+{
+    return write(str);
+}
+
+size_t Print::print(char c)
+{
+    return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char value, int base)
+{
+    return print((unsigned long)value, base);
+}
+
+size_t Print::print(int value, int base)
+{
+    return print((long)value, base);
+}
+
+size_t Print::print(unsigned int value, int base)
+{
+    return print((unsigned long)value, base);
+}
+
+size_t Print::print(long value, int base)
+{
+    if(base == DEC && value < 0)
+    {
+        return print('-') + PrintNumber((unsigned long)-value, DEC);
+    }
+
+    return PrintNumber((unsigned long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+    return PrintNumber(value, base);
+}
+
+size_t Print::print(double value, int digits)
+{
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return print(text);
+}
+
+size_t Print::println()
+{
+    return write((const uint8_t*)"\r\n", 2);
+}
+
+size_t Print::PrintNumber(unsigned long value, int base)
+{
+    char text[8 * sizeof(unsigned long) + 1];
+    char* digit = &text[sizeof(text) - 1];
+    *digit = '\0';
+
+    if(base < 2)
+    {
+        base = DEC;
+    }
+
+    do
+    {
+        const unsigned long remainder = value % base;
+        value /= base;
+        *--digit = (char)(remainder < 10 ? '0' + remainder : 'A' + remainder - 10);
+    }
+    while(value > 0);
+
+    return print(digit);
+}
+
+/*
+*   HardwareSerial
+*/
+HardwareSerial::HardwareSerial()
+    : m_Fd(-1)
+    , m_Baud(0)
+    , m_LastReceive(0)
+    , m_Credit(0)
+    , m_RxHead(0)
+    , m_RxCount(0)
+    , m_NumOverruns(0)
+{
+}
+
+void HardwareSerial::Attach(int fd)
+{
+    m_Fd = fd;
+}
+
+void HardwareSerial::begin(unsigned long baud)
+{
+    m_Baud = baud;
+    m_LastReceive = micros();
+    m_Credit = 0;
+}
+
+void HardwareSerial::end()
+{
+    m_RxCount = 0;
+}
+
+void HardwareSerial::Receive()
+{
+    if(m_Fd < 0)
+        return;
+
+    int pending = 0;
+    if(ioctl(m_Fd, FIONREAD, &pending) != 0 || pending <= 0)
+    {
+        // Idle line, nothing is in flight
+        m_LastReceive = micros();
+        m_Credit = 0;
+        return;
+    }
+
+    size_t numArrived = (size_t)pending;
+
+    if(m_Baud > 0)
+    {
+        const unsigned long now = micros();
+        m_Credit += (now - m_LastReceive) * m_Baud;
+        m_LastReceive = now;
+
+        const unsigned long byteTime = 10UL * 1000000UL;
+        numArrived = (m_Credit / byteTime < numArrived ? m_Credit / byteTime : numArrived);
+        m_Credit -= numArrived * byteTime;
+    }
+
+    while(numArrived > 0)
+    {
+        uint8_t bytes[SERIAL_RX_BUFFER_SIZE];
+        const size_t numToRead = (numArrived < sizeof(bytes) ? numArrived : sizeof(bytes));
+        const ssize_t numRead = ::read(m_Fd, bytes, numToRead);
+        if(numRead <= 0)
+            break;
+
+        for(ssize_t i = 0; i < numRead; i++)
+        {
+            // Same as the AVR core, a full buffer drops the incoming byte
+            if(m_RxCount == SERIAL_RX_BUFFER_SIZE)
+            {
+                m_NumOverruns++;
+                continue;
+            }
+
+            m_RxBuffer[(m_RxHead + m_RxCount) % SERIAL_RX_BUFFER_SIZE] = bytes[i];
+            m_RxCount++;
+        }
+
+        numArrived -= (size_t)numRead;
+    }
+}
+
+int HardwareSerial::available()
+{
+    Receive();
+    return (int)m_RxCount;
+}
+
+int HardwareSerial::read()
+{
+    if(m_RxCount == 0)
+    {
+        Receive();
+        if(m_RxCount == 0)
+            return -1;
+    }
+
+    const uint8_t b = m_RxBuffer[m_RxHead];
+    m_RxHead = (m_RxHead + 1) % SERIAL_RX_BUFFER_SIZE;
+    m_RxCount--;
+    return b;
+}
+
+int HardwareSerial::peek()
+{
+    if(m_RxCount == 0)
+    {
+        Receive();
+        if(m_RxCount == 0)
+            return -1;
+    }
+
+    return m_RxBuffer[m_RxHead];
+}
+
+void HardwareSerial::flush()
+{
+    // Writes go straight to the file descriptor, there is nothing left to transmit
+}
+
+size_t HardwareSerial::write(uint8_t b)
+{
+    return write(&b, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size)
+{
+    size_t numWritten = 0;
+
+    // Without a host attached, output is discarded just like an unconnected UART
+    while(m_Fd >= 0 && numWritten < size)
+    {
+        const ssize_t result = ::write(m_Fd, buffer + numWritten, size - numWritten);
+        if(result <= 0)
+            break;
+
+        numWritten += (size_t)result;
+    }
+
+    return size;
+}
+
+/*
+*   I2CDevice
+*/
+I2CDevice::I2CDevice(uint8_t address, uint8_t registerMask)
+    : m_Address(address)
+    , m_RegisterMask(registerMask)
+    , m_Pointer(0)
+{
+    memset(Registers, 0, sizeof(Registers));
+}
+
+void I2CDevice::OnWrite(const uint8_t* data, size_t size)
+{
+    if(size == 0)
+        return;
+
+    m_Pointer = data[0] & m_RegisterMask;
+
+    for(size_t i = 1; i < size; i++)
+    {
+        Registers[m_Pointer] = data[i];
+        m_Pointer = (m_Pointer + 1) & m_RegisterMask;
+    }
+}
+
+uint8_t I2CDevice::OnRead()
+{
+    const uint8_t value = Registers[m_Pointer];
+    m_Pointer = (m_Pointer + 1) & m_RegisterMask;
+    return value;
+}
+
+/*
+*   TwoWire
+*/
+TwoWire::TwoWire()
+    : m_NumDevices(0)
+    , m_Frequency(100000)
+    , m_bRealtime(false)
+    , m_TxAddress(0)
+    , m_TxSize(0)
+    , m_RxSize(0)
+    , m_RxPosition(0)
+    , m_NumTransactions(0)
+    , m_NumBytes(0)
+{
+}
+
+void TwoWire::Attach(I2CDevice& device)
+{
+    if(m_NumDevices < I2C_MAX_DEVICES)
+    {
+        m_Devices[m_NumDevices++] = &device;
+    }
+}
+
+I2CDevice* TwoWire::FindDevice(uint8_t address) const
+{
+    for(size_t i = 0; i < m_NumDevices; i++)
+    {
+        if(m_Devices[i]->GetAddress() == address)
+            return m_Devices[i];
+    }
+
+    return nullptr;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    m_TxAddress = address;
+    m_TxSize = 0;
+}
+
+void TwoWire::Transfer(size_t numBytes)
+{
+    m_NumTransactions++;
+    m_NumBytes += numBytes;
+
+    if(m_bRealtime)
+    {
+        delayMicroseconds((unsigned int)((numBytes * 9ULL * 1000000ULL) / m_Frequency));
+    }
+}
+
+uint8_t TwoWire::endTransmission(bool)
+{
+    Transfer(1 + m_TxSize);
+
+    I2CDevice* device = FindDevice(m_TxAddress);
+    if(!device)
+        return 2; // Address NACK
+
+    device->OnWrite(m_TxBuffer, m_TxSize);
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool)
+{
+    m_RxSize = 0;
+    m_RxPosition = 0;
+
+    Transfer(1 + quantity);
+
+    I2CDevice* device = FindDevice(address);
+    if(!device)
+        return 0;
+
+    while(m_RxSize < quantity && m_RxSize < I2C_BUFFER_LENGTH)
+    {
+        m_RxBuffer[m_RxSize++] = device->OnRead();
+    }
+
+    return (uint8_t)m_RxSize;
+}
+
+size_t TwoWire::write(uint8_t b)
+{
+    if(m_TxSize == I2C_BUFFER_LENGTH)
+        return 0;
+
+    m_TxBuffer[m_TxSize++] = b;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* buffer, size_t size)
+{
+    size_t numWritten = 0;
+    while(numWritten < size && write(buffer[numWritten]))
+    {
+        numWritten++;
+    }
+    return numWritten;
+}
+
+int TwoWire::available()
+{
+    return (int)(m_RxSize - m_RxPosition);
+}
+
+int TwoWire::read()
+{
+    return (m_RxPosition < m_RxSize ? m_RxBuffer[m_RxPosition++] : -1);
+}
+
+int TwoWire::peek()
+{
+    return (m_RxPosition < m_RxSize ? m_RxBuffer[m_RxPosition] : -1);
+}
+
+unsigned long TwoWire::GetBusTime() const
+{
+    // Start, stop and acks included in the 9 bits per byte, close enough for a budget
+    return (unsigned long)((m_NumBytes * 9ULL * 1000000ULL) / m_Frequency);
+}
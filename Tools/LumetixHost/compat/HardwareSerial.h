@@ -0,0 +1,56 @@
+#ifndef LUMETIX_HOST_HARDWARE_SERIAL_H
+#define LUMETIX_HOST_HARDWARE_SERIAL_H
+
+#include "Arduino.h"
+
+/* Same receive buffer as the AVR core, bytes beyond it are lost if the firmware does not keep up */
+#define SERIAL_RX_BUFFER_SIZE 64
+#define SERIAL_TX_BUFFER_SIZE 64
+
+/*  Host Serial
+*
+*   Serial port of the host firmware, backed by a file descriptor (i.e a pty). Reception is paced at the
+*   configured baud rate, 10 bits per byte, so the firmware sees the same arrival rate as over a real UART.
+*   A baud rate of 0 disables pacing.
+*/
+class HardwareSerial : public Stream
+{
+public:
+    HardwareSerial();
+
+    void Attach(int fd);
+
+    void begin(unsigned long baud);
+    void end();
+
+    virtual int available() override;
+    virtual int read() override;
+    virtual int peek() override;
+    virtual void flush() override;
+
+    virtual size_t write(uint8_t b) override;
+    virtual size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+    /* Writes go straight to the descriptor, the transmit buffer is always empty */
+    int availableForWrite() { return SERIAL_TX_BUFFER_SIZE; }
+    operator bool() const { return m_Fd >= 0; }
+
+    /* Bytes that arrived while the receive buffer was full */
+    inline unsigned long GetNumOverruns() const { return m_NumOverruns; }
+private:
+    void Receive();
+private:
+    int m_Fd;
+    unsigned long m_Baud;
+    unsigned long m_LastReceive;    // us
+    unsigned long m_Credit;         // Bit times available to receive, scaled by 1000000
+
+    uint8_t m_RxBuffer[SERIAL_RX_BUFFER_SIZE];
+    size_t m_RxHead;
+    size_t m_RxCount;
+    unsigned long m_NumOverruns;
+};
+
+extern HardwareSerial Serial;
+#endif // !LUMETIX_HOST_HARDWARE_SERIAL_H
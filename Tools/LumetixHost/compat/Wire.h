@@ -0,0 +1,87 @@
+#ifndef LUMETIX_HOST_WIRE_H
+#define LUMETIX_HOST_WIRE_H
+
+#include "Arduino.h"
+
+#define I2C_MAX_DEVICES 8
+#define I2C_BUFFER_LENGTH 32
+
+/*  Simulated I2C device: a register file with an auto-incrementing register pointer.
+*   The first byte of a write selects the register, following bytes are written from there on.
+*/
+class I2CDevice
+{
+public:
+    I2CDevice(uint8_t address, uint8_t registerMask);
+    virtual ~I2CDevice() {}
+
+    inline uint8_t GetAddress() const { return m_Address; }
+
+    virtual void OnWrite(const uint8_t* data, size_t size);
+    virtual uint8_t OnRead();
+
+    uint8_t Registers[32];
+protected:
+    uint8_t m_Address;
+    uint8_t m_RegisterMask;
+    uint8_t m_Pointer;
+};
+
+/*  Host Wire
+*
+*   I2C bus with simulated devices attached instead of hardware. Transactions to an address nobody
+*   answers to are NACKed, like on a real bus. Counts the traffic so the loopback can report bus usage.
+*/
+class TwoWire : public Stream
+{
+public:
+    TwoWire();
+
+    void Attach(I2CDevice& device);
+
+    void begin() {}
+    void setClock(unsigned long frequency) { m_Frequency = frequency; }
+
+    /* Makes every transaction take as long as it would on a real bus at the set clock */
+    void SetRealtime(bool bRealtime) { m_bRealtime = bRealtime; }
+
+    void beginTransmission(uint8_t address);
+    uint8_t endTransmission(bool bStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, bool bStop = true);
+
+    virtual size_t write(uint8_t b) override;
+    virtual size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+    virtual int available() override;
+    virtual int read() override;
+    virtual int peek() override;
+
+    inline unsigned long GetNumTransactions() const { return m_NumTransactions; }
+    inline unsigned long GetNumBytes() const { return m_NumBytes; }
+
+    /* Time the traffic so far would have kept a real bus busy, 9 bit times per byte including the address */
+    unsigned long GetBusTime() const;
+private:
+    I2CDevice* FindDevice(uint8_t address) const;
+    void Transfer(size_t numBytes);
+private:
+    I2CDevice* m_Devices[I2C_MAX_DEVICES];
+    size_t m_NumDevices;
+    unsigned long m_Frequency;
+    bool m_bRealtime;
+
+    uint8_t m_TxAddress;
+    uint8_t m_TxBuffer[I2C_BUFFER_LENGTH];
+    size_t m_TxSize;
+
+    uint8_t m_RxBuffer[I2C_BUFFER_LENGTH];
+    size_t m_RxSize;
+    size_t m_RxPosition;
+
+    unsigned long m_NumTransactions;
+    unsigned long m_NumBytes;
+};
+
+extern TwoWire Wire;
+#endif // !LUMETIX_HOST_WIRE_H
@@ -0,0 +1,17 @@
+#ifndef LUMETIX_HOST_PGMSPACE_H
+#define LUMETIX_HOST_PGMSPACE_H
+
+#include <string.h>
+
+/* Flash is ordinary memory on the host */
+#ifndef PROGMEM
+    #define PROGMEM
+#endif
+
+#define pgm_read_byte(address) (*(const uint8_t*)(address))
+#define pgm_read_word(address) (*(const uint16_t*)(address))
+#define pgm_read_dword(address) (*(const uint32_t*)(address))
+#define pgm_read_float(address) (*(const float*)(address))
+#define memcpy_P memcpy
+
+#endif // !LUMETIX_HOST_PGMSPACE_H
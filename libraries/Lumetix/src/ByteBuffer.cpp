@@ -5,56 +5,124 @@ const char* ByteBuffer::s_OverflowMsg = "Buffer overflow detected!\n";
 ByteBuffer ByteBuffer::Allocate(size_t numBytes)
 {
     ByteBuffer outBuffer;
-    outBuffer.m_Count = numBytes;
-    outBuffer.m_rpos = 0;
-    outBuffer.m_wpos = 0;
-
-    outBuffer.m_Data = (byte*)(malloc(sizeof(byte) * numBytes));
+    outBuffer.Resize(numBytes);
     return outBuffer;
 }
 
 ByteBuffer::ByteBuffer()
-    : m_Data(nullptr)
-    , m_Count(0)
-    , m_rpos(0)
+    : m_rpos(0)
     , m_wpos(0)
+    , m_Data(m_Inline)
+    , m_Count(0)
+    , m_Capacity(BYTE_BUFFER_INLINE_CAPACITY)
+{
+}
+
+ByteBuffer::ByteBuffer(ByteBuffer&& Other)
+    : ByteBuffer()
 {
+    MoveFrom(Other);
 }
 
 ByteBuffer::~ByteBuffer()
 {
-    if(m_Data)
+    FreeStorage();
+}
+
+ByteBuffer& ByteBuffer::operator=(ByteBuffer&& Other)
+{
+    if(this != &Other)
+    {
+        FreeStorage();
+        MoveFrom(Other);
+    }
+
+    return *this;
+}
+
+void ByteBuffer::MoveFrom(ByteBuffer& Other)
+{
+    m_rpos = Other.m_rpos;
+    m_wpos = Other.m_wpos;
+    m_Count = Other.m_Count;
+    m_Capacity = Other.m_Capacity;
+
+    if(Other.IsInline())
     {
-        free (m_Data);
-        m_Data = nullptr;
+        m_Data = m_Inline;
+        memcpy(m_Inline, Other.m_Inline, Other.m_Count);
     }
+    else
+    {
+        // Steal the heap storage, other is left empty but usable
+        m_Data = Other.m_Data;
+        Other.m_Data = Other.m_Inline;
+        Other.m_Capacity = BYTE_BUFFER_INLINE_CAPACITY;
+    }
+
+    Other.m_Count = 0;
+    Other.m_rpos = 0;
+    Other.m_wpos = 0;
 }
 
-ByteBuffer& ByteBuffer::Resize(size_t numBytes)
+void ByteBuffer::FreeStorage()
 {
-    if(m_Data)
+    if(!IsInline())
     {
         free(m_Data);
-        m_Data = nullptr;
     }
 
-    m_Count = numBytes;
+    m_Data = m_Inline;
+    m_Capacity = BYTE_BUFFER_INLINE_CAPACITY;
+}
+
+ByteBuffer& ByteBuffer::Resize(size_t numBytes)
+{
     m_rpos = 0;
     m_wpos = 0;
-    m_Data = (byte*)malloc(sizeof(byte) * numBytes);
 
+    if(numBytes > m_Capacity)
+    {
+        FreeStorage();
+
+        byte* data = (byte*)malloc(sizeof(byte) * numBytes);
+        if(!data)
+        {
+            // Out of memory, any access will be reported as an overflow
+            Serial.println(s_OverflowMsg);
+            m_Count = 0;
+            return *this;
+        }
+
+        m_Data = data;
+        m_Capacity = numBytes;
+    }
+
+    m_Count = numBytes;
     return *this;
 }
 
+bool ByteBuffer::CheckBounds(uint32_t pos, size_t count) const
+{
+    if(pos > m_Count || count > m_Count - pos)
+    {
+        Serial.println(s_OverflowMsg);
+        abort();
+        return false;
+    }
+
+    return true;
+}
+
 ByteBuffer& ByteBuffer::PutByte(byte b)
 {
     Write<byte>(b);
     return *this;
 }
 
-ByteBuffer& ByteBuffer::PutInt(long i)
+ByteBuffer& ByteBuffer::PutInt(int32_t i)
 {
-    Write<long>(i);
+    Write<int32_t>(i);
     return *this;
 }
 
@@ -70,9 +138,9 @@ ByteBuffer& ByteBuffer::PutDouble(double d)
     return *this;
 }
 
-ByteBuffer& ByteBuffer::PutShort(short s)
+ByteBuffer& ByteBuffer::PutShort(int16_t s)
 {
-    Write<short>(s);
+    Write<int16_t>(s);
     return *this;
 }
 
@@ -82,14 +150,12 @@ ByteBuffer& ByteBuffer::PutChar(char c)
     return *this;
 }
 
-ByteBuffer& ByteBuffer::PutBytes(byte* bytes, size_t count)
+ByteBuffer& ByteBuffer::PutBytes(const byte* bytes, size_t count)
 {
-    if(bytes)
+    if(bytes && CheckBounds(m_wpos, count))
     {
-        for(int i = 0; i < count; i++)
-        {
-            PutByte(bytes[i]);
-        }
+        memcpy(&m_Data[m_wpos], bytes, count);
+        m_wpos += count;
     }
 
     return *this;
@@ -108,7 +174,11 @@ byte ByteBuffer::Get(uint32_t idx)
 
 void ByteBuffer::GetBytes(byte* inOutBytes, size_t count)
 {
-    memcpy(inOutBytes, m_Data, count);
+    if(inOutBytes && CheckBounds(m_rpos, count))
+    {
+        memcpy(inOutBytes, &m_Data[m_rpos], count);
+        m_rpos += count;
+    }
 }
 
 byte ByteBuffer::GetByte()
@@ -116,9 +186,9 @@ byte ByteBuffer::GetByte()
     return Read<byte>();
 }
 
-long ByteBuffer::GetInt()
+int32_t ByteBuffer::GetInt()
 {
-    return Read<long>();
+    return Read<int32_t>();
 }
 
 float ByteBuffer::GetFloat()
@@ -131,9 +201,9 @@ double ByteBuffer::GetDouble()
     return Read<double>();
 }
 
-short ByteBuffer::GetShort()
+int16_t ByteBuffer::GetShort()
 {
-    return Read<short>();
+    return Read<int16_t>();
 }
 
 char ByteBuffer::GetChar()
@@ -3,38 +3,59 @@
 #include <Arduino.h> // Unfortunate... also includes stdio
 #include <string.h>
 
+#include "ByteCodec.h"
+
+/* Buffers up to this size live within the ByteBuffer itself and never touch the heap */
+#define BYTE_BUFFER_INLINE_CAPACITY 24
+
 /*  Byte Buffer class that emulates the Android/Java buffer functionalities 
 *   This class can be used to perform compatible operations and transmissions
 *   of raw data between Android and Arduino.
+*
+*   Small buffers are stored inline, larger ones are malloced. Buffers are move-only: copies would
+*   either share the heap storage or silently copy it, pass them by reference instead.
+*   Resize reuses the current capacity whenever it is large enough, so a buffer reused for every
+*   message only allocates when a message larger than all previous ones arrives.
+*
+*   Values are stored little endian with explicit widths (see ByteCodec.h), matching what Android's
+*   ByteBuffer produces once set to ByteOrder.LITTLE_ENDIAN.
 */
 struct ByteBuffer
 {
     static ByteBuffer Allocate(size_t numBytes);
+    ByteBuffer(ByteBuffer&& Other);
+    ByteBuffer(const ByteBuffer& Other) = delete;
     ~ByteBuffer();
+    ByteBuffer& operator=(ByteBuffer&& Other);
     ByteBuffer& operator=(const ByteBuffer& Other) = delete;
 
+    /* Discards the content. Storage is only reallocated if numBytes exceeds the capacity */
     ByteBuffer& Resize(size_t numBytes);
 
     ByteBuffer& PutByte(byte b);
-    ByteBuffer& PutInt(long i);  // IMPORTANT. Size mismatch between Arduino and Android possible. Be explicit! (uint32_t ?). "FIXED": Using long for 4-bytes
+    ByteBuffer& PutInt(int32_t i);
     ByteBuffer& PutFloat(float f);
-    ByteBuffer& PutDouble(double d);
-    ByteBuffer& PutShort(short s);
+    ByteBuffer& PutDouble(double d);    // IMPORTANT. double is 4 bytes on AVR, 8 on Android. Prefer floats
+    ByteBuffer& PutShort(int16_t s);
     ByteBuffer& PutChar(char c);
-    ByteBuffer& PutBytes(byte* bytes, size_t count);
+    ByteBuffer& PutBytes(const byte* bytes, size_t count);
 
     void        GetBytes(byte* inOutBytes, size_t count);
     byte        GetByte();
-    long        GetInt();
+    int32_t     GetInt();
     float       GetFloat();
     double      GetDouble();
-    short       GetShort();
+    int16_t     GetShort();
     char        GetChar();
     
     byte* ToByteArray() const;
     byte  Get();                    // Relative Get Method
     byte  Get(uint32_t idx);        // Absolute Get Method
     inline size_t GetNumBytes() const { return m_Count; }
+    inline size_t GetNumWritten() const { return m_wpos; }
+    inline const byte* GetData() const { return m_Data; }
+    inline size_t GetCapacity() const { return m_Capacity; }
+    inline bool IsInline() const { return m_Data == m_Inline; }
 
 private:
     template<typename T>
@@ -50,11 +71,16 @@ private:
     void Write(uint32_t pos, T data);
 
     ByteBuffer();
+    void MoveFrom(ByteBuffer& Other);
+    bool CheckBounds(uint32_t pos, size_t count) const;
+    void FreeStorage();
 private:
     uint32_t m_rpos;
     uint32_t m_wpos;
-    byte* m_Data;
+    byte* m_Data;           // Either m_Inline or heap storage
     size_t m_Count;
+    size_t m_Capacity;
+    byte m_Inline[BYTE_BUFFER_INLINE_CAPACITY];
 
     static const char* s_OverflowMsg;
 };
@@ -71,14 +97,10 @@ T ByteBuffer::Read()
 template<typename T>
 T ByteBuffer::Read(uint32_t pos)
 {
-    if((pos + sizeof(T)) > m_Count)
-    {
-        Serial.println(s_OverflowMsg);
-        abort();
+    if(!CheckBounds(pos, sizeof(T)))
         return (T)0;
-    }
 
-    return  *( (T*)(&m_Data[pos]) );
+    return LoadLE<T>(&m_Data[pos]);
 }
 
 template<typename T>
@@ -91,14 +113,9 @@ void ByteBuffer::Write(T data)
 template<typename T>
 void ByteBuffer::Write(uint32_t pos, T data)
 {
-    if(pos + sizeof(T) > m_Count)
-    {
-        Serial.println(s_OverflowMsg);
-        abort();
+    if(!CheckBounds(pos, sizeof(T)))
         return;
-    }
 
-    // memset/memcpy doesn't work on arduino for some reason
-    memcpy(&m_Data[pos], (void*)&data, sizeof(T));
+    StoreLE<T>(&m_Data[pos], data);
 }
 #endif // !BYTE_BUFFER_H
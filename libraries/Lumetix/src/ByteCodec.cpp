@@ -0,0 +1,129 @@
+#include "ByteCodec.h"
+
+ByteWriter::ByteWriter(byte* data, size_t capacity)
+    : m_Data(data)
+    , m_Capacity(data ? capacity : 0)
+    , m_Pos(0)
+    , m_bOverflow(false)
+{
+}
+
+byte* ByteWriter::Reserve(size_t count)
+{
+    if(m_bOverflow || count > m_Capacity - m_Pos)
+    {
+        m_bOverflow = true;
+        return nullptr;
+    }
+
+    byte* dst = m_Data + m_Pos;
+    m_Pos += count;
+    return dst;
+}
+
+ByteWriter& ByteWriter::PutByte(byte b)
+{
+    if(byte* dst = Reserve(1))
+    {
+        *dst = b;
+    }
+    return *this;
+}
+
+ByteWriter& ByteWriter::PutBytes(const byte* bytes, size_t count)
+{
+    if(!bytes)
+        return *this;
+
+    if(byte* dst = Reserve(count))
+    {
+        memcpy(dst, bytes, count);
+    }
+    return *this;
+}
+
+ByteWriter& ByteWriter::PutVarint(uint32_t value)
+{
+    // 7 bits per byte, least significant group first, high bit set on all but the last byte
+    while(value >= 0x80)
+    {
+        PutByte((byte)(value | 0x80));
+        value >>= 7;
+    }
+    return PutByte((byte)value);
+}
+
+ByteWriter& ByteWriter::PutSignedVarint(int32_t value)
+{
+    // Zigzag maps small magnitudes of either sign to small codes: 0, -1, 1, -2 -> 0, 1, 2, 3
+    const uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    return PutVarint(zigzag);
+}
+
+ByteReader::ByteReader(const byte* data, size_t numBytes)
+    : m_Data(data)
+    , m_NumBytes(data ? numBytes : 0)
+    , m_Pos(0)
+    , m_bOverflow(false)
+{
+}
+
+const byte* ByteReader::Consume(size_t count)
+{
+    if(m_bOverflow || count > m_NumBytes - m_Pos)
+    {
+        m_bOverflow = true;
+        return nullptr;
+    }
+
+    const byte* src = m_Data + m_Pos;
+    m_Pos += count;
+    return src;
+}
+
+byte ByteReader::GetByte()
+{
+    const byte* src = Consume(1);
+    return (src ? *src : 0);
+}
+
+bool ByteReader::GetBytes(byte* outBytes, size_t count)
+{
+    const byte* src = Consume(count);
+    if(!src)
+        return false;
+
+    memcpy(outBytes, src, count);
+    return true;
+}
+
+bool ByteReader::Skip(size_t count)
+{
+    return Consume(count) != nullptr;
+}
+
+uint32_t ByteReader::GetVarint()
+{
+    uint32_t value = 0;
+
+    for(int i = 0; i < VARINT_MAX_BYTES; i++)
+    {
+        const byte* src = Consume(1);
+        if(!src)
+            return 0;
+
+        value |= (uint32_t)(*src & 0x7F) << (7 * i);
+        if((*src & 0x80) == 0)
+            return value;
+    }
+
+    // More than 5 groups can not be a 32 bit value, the stream is corrupt
+    m_bOverflow = true;
+    return 0;
+}
+
+int32_t ByteReader::GetSignedVarint()
+{
+    const uint32_t zigzag = GetVarint();
+    return (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+}
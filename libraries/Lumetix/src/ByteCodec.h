@@ -0,0 +1,219 @@
+#ifndef BYTE_CODEC_H
+#define BYTE_CODEC_H
+
+#include <Arduino.h>
+#include <string.h>
+
+/*  Byte Codec
+*
+*   Portable serialization primitives. Every multi-byte value has an explicit width and byte order, so
+*   the wire format is the same on the AVR firmware, the host tools and the Android side, regardless of
+*   the size of long or double or of the native endianness. The Lumetix protocol is little endian.
+*
+*   StoreLE/LoadLE (and BE) encode a single value at a given address. ByteWriter and ByteReader are checked
+*   cursors over a caller owned buffer: any access beyond the end sets a sticky error flag instead of
+*   aborting, reads then return 0. Check IsValid() once after a sequence of operations.
+*/
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    #define BYTE_CODEC_NATIVE_LE 1
+#else
+    #define BYTE_CODEC_NATIVE_LE 0
+#endif
+
+/* Largest encoding of a 32 bit LEB128 varint */
+#define VARINT_MAX_BYTES 5
+
+template<size_t N> struct UintOfSize;
+template<> struct UintOfSize<1> { typedef uint8_t Type; };
+template<> struct UintOfSize<2> { typedef uint16_t Type; };
+template<> struct UintOfSize<4> { typedef uint32_t Type; };
+template<> struct UintOfSize<8> { typedef uint64_t Type; };
+
+template<typename T>
+inline void StoreLE(byte* dst, T value)
+{
+    typename UintOfSize<sizeof(T)>::Type bits;
+    memcpy(&bits, &value, sizeof(T));
+
+    for(size_t i = 0; i < sizeof(T); i++)
+    {
+        dst[i] = (byte)(bits >> (8 * i));
+    }
+}
+
+template<typename T>
+inline void StoreBE(byte* dst, T value)
+{
+    typename UintOfSize<sizeof(T)>::Type bits;
+    memcpy(&bits, &value, sizeof(T));
+
+    for(size_t i = 0; i < sizeof(T); i++)
+    {
+        dst[sizeof(T) - 1 - i] = (byte)(bits >> (8 * i));
+    }
+}
+
+template<typename T>
+inline T LoadLE(const byte* src)
+{
+    typedef typename UintOfSize<sizeof(T)>::Type U;
+
+    U bits = 0;
+    for(size_t i = 0; i < sizeof(T); i++)
+    {
+        bits |= (U)src[i] << (8 * i);
+    }
+
+    T value;
+    memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+template<typename T>
+inline T LoadBE(const byte* src)
+{
+    typedef typename UintOfSize<sizeof(T)>::Type U;
+
+    U bits = 0;
+    for(size_t i = 0; i < sizeof(T); i++)
+    {
+        bits |= (U)src[sizeof(T) - 1 - i] << (8 * i);
+    }
+
+    T value;
+    memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+class ByteWriter
+{
+public:
+    ByteWriter(byte* data, size_t capacity);
+
+    template<typename T> ByteWriter& PutLE(T value);
+    template<typename T> ByteWriter& PutBE(T value);
+
+    /* Little endian array, a single memcpy on little endian targets */
+    template<typename T> ByteWriter& PutArrayLE(const T* values, size_t count);
+
+    ByteWriter& PutByte(byte b);
+    ByteWriter& PutBytes(const byte* bytes, size_t count);
+
+    /* Unsigned LEB128, and zigzag encoded LEB128 for signed values */
+    ByteWriter& PutVarint(uint32_t value);
+    ByteWriter& PutSignedVarint(int32_t value);
+
+    inline bool IsValid() const { return !m_bOverflow; }
+    inline size_t GetPosition() const { return m_Pos; }
+    inline size_t GetRemaining() const { return m_Capacity - m_Pos; }
+    inline const byte* GetData() const { return m_Data; }
+private:
+    /* Reserves count bytes, or flags an overflow and returns null */
+    byte* Reserve(size_t count);
+private:
+    byte* m_Data;
+    size_t m_Capacity;
+    size_t m_Pos;
+    bool m_bOverflow;
+};
+
+class ByteReader
+{
+public:
+    ByteReader(const byte* data, size_t numBytes);
+
+    template<typename T> T GetLE();
+    template<typename T> T GetBE();
+    template<typename T> bool GetArrayLE(T* outValues, size_t count);
+
+    byte GetByte();
+    bool GetBytes(byte* outBytes, size_t count);
+    bool Skip(size_t count);
+
+    uint32_t GetVarint();
+    int32_t GetSignedVarint();
+
+    inline bool IsValid() const { return !m_bOverflow; }
+    inline size_t GetPosition() const { return m_Pos; }
+    inline size_t GetRemaining() const { return m_NumBytes - m_Pos; }
+private:
+    /* Consumes count bytes, or flags an overflow and returns null */
+    const byte* Consume(size_t count);
+private:
+    const byte* m_Data;
+    size_t m_NumBytes;
+    size_t m_Pos;
+    bool m_bOverflow;
+};
+
+template<typename T>
+ByteWriter& ByteWriter::PutLE(T value)
+{
+    if(byte* dst = Reserve(sizeof(T)))
+    {
+        StoreLE<T>(dst, value);
+    }
+    return *this;
+}
+
+template<typename T>
+ByteWriter& ByteWriter::PutBE(T value)
+{
+    if(byte* dst = Reserve(sizeof(T)))
+    {
+        StoreBE<T>(dst, value);
+    }
+    return *this;
+}
+
+template<typename T>
+ByteWriter& ByteWriter::PutArrayLE(const T* values, size_t count)
+{
+    byte* dst = Reserve(sizeof(T) * count);
+    if(!dst)
+        return *this;
+
+#if BYTE_CODEC_NATIVE_LE
+    memcpy(dst, values, sizeof(T) * count);
+#else
+    for(size_t i = 0; i < count; i++)
+    {
+        StoreLE<T>(dst + i * sizeof(T), values[i]);
+    }
+#endif
+    return *this;
+}
+
+template<typename T>
+T ByteReader::GetLE()
+{
+    const byte* src = Consume(sizeof(T));
+    return (src ? LoadLE<T>(src) : (T)0);
+}
+
+template<typename T>
+T ByteReader::GetBE()
+{
+    const byte* src = Consume(sizeof(T));
+    return (src ? LoadBE<T>(src) : (T)0);
+}
+
+template<typename T>
+bool ByteReader::GetArrayLE(T* outValues, size_t count)
+{
+    const byte* src = Consume(sizeof(T) * count);
+    if(!src)
+        return false;
+
+#if BYTE_CODEC_NATIVE_LE
+    memcpy(outValues, src, sizeof(T) * count);
+#else
+    for(size_t i = 0; i < count; i++)
+    {
+        outValues[i] = LoadLE<T>(src + i * sizeof(T));
+    }
+#endif
+    return true;
+}
+#endif // !BYTE_CODEC_H
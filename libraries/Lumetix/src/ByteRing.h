@@ -0,0 +1,180 @@
+#ifndef BYTE_RING_H
+#define BYTE_RING_H
+
+#include <Arduino.h>
+#include <string.h>
+
+#ifdef __AVR__
+    #include <util/atomic.h>
+#endif
+
+/* Contiguous run of bytes within a ring, valid until the consumer releases it */
+struct ByteSpan
+{
+    const byte* Data;
+    size_t Size;
+};
+
+/* Indices are free running, they only need to count up to twice the capacity to tell full from empty */
+template<bool bSmall> struct RingIndex       { typedef uint8_t Type; };
+template<>            struct RingIndex<false> { typedef uint16_t Type; };
+
+/*  Byte Ring
+*
+*   Lock-free single-producer/single-consumer byte queue. The producer (i.e the UART receive path, possibly
+*   an ISR) only ever writes the head, the consumer (the protocol parser in the main loop) only ever writes
+*   the tail. Each side publishes its index with a single atomic store once the bytes are in place, so
+*   neither side ever needs to disable interrupts for longer than an index access.
+*
+*   Capacity must be a power of two. Up to 128 bytes, indices are single bytes and naturally atomic on AVR.
+*
+*   Consumers can either pop bytes, or parse in place: PeekSpan returns the readable bytes up to the end of
+*   the storage (call again after Release for the part that wrapped around).
+*/
+template<size_t Capacity>
+class ByteRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "ByteRing capacity must be a power of two");
+    static_assert(Capacity <= 32768, "ByteRing capacity is too large");
+
+    typedef typename RingIndex<(Capacity <= 128)>::Type Index;
+public:
+    ByteRing()
+        : m_Head(0)
+        , m_Tail(0)
+        , m_NumDropped(0)
+    {
+    }
+
+    /* Producer side */
+    bool Push(byte b)
+    {
+        const Index head = m_Head;
+        if((Index)(head - LoadIndex(m_Tail)) == Capacity)
+        {
+            m_NumDropped++;
+            return false;
+        }
+
+        m_Data[head & (Capacity - 1)] = b;
+        StoreIndex(m_Head, (Index)(head + 1));
+        return true;
+    }
+
+    size_t Write(const byte* bytes, size_t count)
+    {
+        const Index head = m_Head;
+        const size_t free = Capacity - (Index)(head - LoadIndex(m_Tail));
+        const size_t numWritten = (count < free ? count : free);
+
+        // At most two copies, before and after the wrap around
+        const size_t start = head & (Capacity - 1);
+        const size_t first = (numWritten < Capacity - start ? numWritten : Capacity - start);
+        memcpy(&m_Data[start], bytes, first);
+        memcpy(&m_Data[0], bytes + first, numWritten - first);
+
+        m_NumDropped += count - numWritten;
+        StoreIndex(m_Head, (Index)(head + numWritten));
+        return numWritten;
+    }
+
+    /* Moves everything the stream has received into the ring, without ever waiting on it */
+    template<typename TStream>
+    size_t Fill(TStream& stream)
+    {
+        size_t numRead = 0;
+        int available = stream.available();
+
+        while(available-- > 0 && GetFree() > 0)
+        {
+            Push((byte)stream.read());
+            numRead++;
+        }
+
+        return numRead;
+    }
+
+    /* Consumer side */
+    size_t GetAvailable() const { return (Index)(LoadIndex(m_Head) - m_Tail); }
+    size_t GetFree() const { return Capacity - (Index)(m_Head - LoadIndex(m_Tail)); }
+    constexpr size_t GetCapacity() const { return Capacity; }
+
+    bool Pop(byte& outByte)
+    {
+        if(GetAvailable() == 0)
+            return false;
+
+        outByte = m_Data[m_Tail & (Capacity - 1)];
+        StoreIndex(m_Tail, (Index)(m_Tail + 1));
+        return true;
+    }
+
+    /* Byte at offset from the read position. Offset must be less than GetAvailable() */
+    byte Peek(size_t offset = 0) const
+    {
+        return m_Data[(m_Tail + offset) & (Capacity - 1)];
+    }
+
+    ByteSpan PeekSpan() const
+    {
+        const size_t available = GetAvailable();
+        const size_t start = m_Tail & (Capacity - 1);
+        const size_t contiguous = Capacity - start;
+
+        ByteSpan span = { &m_Data[start], (available < contiguous ? available : contiguous) };
+        return span;
+    }
+
+    /* Releases count bytes from the read position back to the producer */
+    void Release(size_t count)
+    {
+        const size_t available = GetAvailable();
+        StoreIndex(m_Tail, (Index)(m_Tail + (count < available ? count : available)));
+    }
+
+    void Clear() { Release(GetAvailable()); }
+
+    /* Bytes the producer had to discard because the ring was full */
+    inline unsigned long GetNumDropped() const { return m_NumDropped; }
+private:
+    static Index LoadIndex(const volatile Index& index)
+    {
+    #ifdef __AVR__
+        if(sizeof(Index) == 1)
+        {
+            const Index value = index;
+            __asm__ __volatile__("" ::: "memory");
+            return value;
+        }
+
+        Index value;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { value = index; }
+        return value;
+    #else
+        return __atomic_load_n(&index, __ATOMIC_ACQUIRE);
+    #endif
+    }
+
+    static void StoreIndex(volatile Index& index, Index value)
+    {
+    #ifdef __AVR__
+        if(sizeof(Index) == 1)
+        {
+            // Bytes must be in place before the index publishes them
+            __asm__ __volatile__("" ::: "memory");
+            index = value;
+            return;
+        }
+
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { index = value; }
+    #else
+        __atomic_store_n(&index, value, __ATOMIC_RELEASE);
+    #endif
+    }
+private:
+    byte m_Data[Capacity];
+    volatile Index m_Head;  // Written by the producer only
+    volatile Index m_Tail;  // Written by the consumer only
+    volatile unsigned long m_NumDropped;
+};
+#endif // !BYTE_RING_H
@@ -2,9 +2,7 @@
 #define CONTEXT_H
 
 #include "LedPanel.h"
-#include "../../SparkFun_ISL29125_Breakout_Arduino_Library-master/src/SparkFunISL29125.h"
-
-typedef SFE_ISL29125 RGBSensor;
+#include "RgbSampler.h"
 
 /* Global context to facilitate working of de-coupled features such as Effects 
 *  Simply include this header and access gContext. gContext must be defined in the .ino file
@@ -15,11 +13,15 @@ struct Context
     Context(LedPanel& panel, RGBSensor& sensor)
     : Panel(panel)
     , RgbSensor(sensor)
+    , Sampler(sensor)
     {
     }
 
     LedPanel& Panel;
     RGBSensor& RgbSensor;
+
+    /* Prefer consuming samples from here over reading the sensor directly */
+    RgbSampler Sampler;
 };
 extern Context* gContext;
 #endif // !CONTEXT_H
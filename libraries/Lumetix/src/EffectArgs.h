@@ -0,0 +1,139 @@
+#ifndef EFFECT_ARGS_H
+#define EFFECT_ARGS_H
+
+#include <Arduino.h>
+
+/* Largest argument payload an effect can receive, in bytes */
+#define EFFECT_ARGS_MAX_BYTES 16
+
+/*  Arguments received for an effect. This is a view on the received bytes, it does not own them
+*   and is only valid for the duration of OnSetArgs.
+*/
+struct EffectArgs
+{
+    const byte* Data;
+    size_t NumBytes;
+
+    EffectArgs(const byte* data = nullptr, size_t numBytes = 0)
+        : Data(data)
+        , NumBytes(numBytes)
+    {
+    }
+};
+
+/*  Argument fields
+*
+*   Describe a single field of an effect's arguments: its type, valid range and, for optional
+*   fields, the default used when the field is missing from the packet. Integral types of up to
+*   4 bytes are supported and are transmitted little endian.
+*/
+template<typename T, long Min, long Max>
+struct Arg
+{
+    static_assert(sizeof(T) <= sizeof(unsigned long), "Argument type is too large");
+
+    static constexpr size_t Size = sizeof(T);
+    static constexpr bool bOptional = false;
+    static constexpr long Default = Min;
+
+    static T Read(const byte* data)
+    {
+        unsigned long value = 0;
+        for(size_t i = 0; i < Size; i++)
+        {
+            value |= (unsigned long)data[i] << (8 * i);
+        }
+        return (T)value;
+    }
+
+    static bool InRange(T value) { return (long)value >= Min && (long)value <= Max; }
+};
+
+template<typename T, long Min, long Max, long DefaultValue>
+struct OptionalArg : Arg<T, Min, Max>
+{
+    static constexpr bool bOptional = true;
+    static constexpr long Default = DefaultValue;
+};
+
+/*  Argument Schema
+*
+*   Compile-time description of an effect's arguments, as a list of Arg/OptionalArg fields.
+*   Optional fields must come last, a packet may omit any number of trailing optional fields.
+*
+*   Decode validates the whole packet before writing anything, straight from the received bytes into
+*   the given destinations (typically the effect's own fields). A packet of the wrong size is rejected
+*   before any byte is read, a field out of range rejects the packet and leaves the destinations untouched.
+*
+*   typedef ArgSchema<Arg<byte, 0, 255>, OptionalArg<byte, 0, 1, 1>> ArgsSchema;
+*   if(ArgsSchema::Decode(args, m_Value, m_bFlag)) { ... }
+*/
+template<typename... Fields> struct ArgSchema;
+
+template<>
+struct ArgSchema<>
+{
+    static constexpr size_t MinBytes = 0;
+    static constexpr size_t MaxBytes = 0;
+    static constexpr bool bAllOptional = true;
+
+    static bool Validate(const byte*, size_t numBytes) { return numBytes == 0; }
+    static void Unpack(const byte*, size_t) {}
+};
+
+template<typename F, typename... Fs>
+struct ArgSchema<F, Fs...>
+{
+    typedef ArgSchema<Fs...> Next;
+
+    static_assert(!F::bOptional || Next::bAllOptional, "Optional arguments must come last");
+
+    static constexpr size_t MinBytes = (F::bOptional ? 0 : F::Size) + Next::MinBytes;
+    static constexpr size_t MaxBytes = F::Size + Next::MaxBytes;
+    static constexpr bool bAllOptional = F::bOptional && Next::bAllOptional;
+
+    static_assert(MaxBytes <= EFFECT_ARGS_MAX_BYTES, "Arguments exceed EFFECT_ARGS_MAX_BYTES");
+
+    template<typename... Outs>
+    static bool Decode(const EffectArgs& args, Outs&... outs)
+    {
+        static_assert(sizeof...(Outs) == sizeof...(Fs) + 1, "One destination is expected per argument");
+
+        if(!args.Data || args.NumBytes < MinBytes || args.NumBytes > MaxBytes)
+            return false;
+
+        if(!Validate(args.Data, args.NumBytes))
+            return false;
+
+        Unpack(args.Data, args.NumBytes, outs...);
+        return true;
+    }
+
+    /* Packet must end on a field boundary, missing fields are optional as guaranteed by MinBytes */
+    static bool Validate(const byte* data, size_t numBytes)
+    {
+        if(numBytes == 0)
+            return true;
+
+        if(numBytes < F::Size || !F::InRange(F::Read(data)))
+            return false;
+
+        return Next::Validate(data + F::Size, numBytes - F::Size);
+    }
+
+    template<typename Out, typename... Outs>
+    static void Unpack(const byte* data, size_t numBytes, Out& out, Outs&... outs)
+    {
+        if(numBytes >= F::Size)
+        {
+            out = static_cast<Out>(F::Read(data));
+            Next::Unpack(data + F::Size, numBytes - F::Size, outs...);
+        }
+        else
+        {
+            out = static_cast<Out>(F::Default);
+            Next::Unpack(data, 0, outs...);
+        }
+    }
+};
+#endif // !EFFECT_ARGS_H
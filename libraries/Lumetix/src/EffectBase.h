@@ -2,7 +2,7 @@
 #define EFFECTS_BASE_H
 
 #include "Context.h"
-#include "ByteBuffer.h"
+#include "EffectArgs.h"
 
 enum class EffectType
 {
@@ -10,18 +10,6 @@ enum class EffectType
     VIDEO_EFFECT
 };
 
-struct EffectArgs
-{
-    ByteBuffer ArgBuffer;
-    size_t NumArgs;
-
-    EffectArgs()
-    : ArgBuffer(ByteBuffer::Allocate(1))
-    , NumArgs(0)
-    {
-    }
-};
-
 /*  Represents an Effect that modulates the behavior of the Led Panel
 *   This is the class/OOP representation of an effect. Depending on 
 *   preference and number of supported effects, this may be more desirable.
@@ -31,7 +19,8 @@ struct EffectArgs
 *   ASIDE: Should effects be persistent (statically created and swapped in realtime),
 *   or should they be malloced on demand? The former is more intuitive since effects
 *   are RESOURCES! But effects might store variables like curves and response - having
-*   over 10 effects will huge memory footprint! Prefer mallocing on demand for now.
+*   over 10 effects will huge memory footprint! Effects are now constructed on demand into
+*   a fixed arena owned by the EffectRegistry, so an effect's state only lives while it is active.
 */
 class EffectBase
 {
@@ -41,9 +30,11 @@ public:
     {
     }
 
-    virtual ~EffectBase(){}
-
-    /* User Defined Overridable methods 
+    /* Effect methods, called directly by the EffectRegistry through the compile-time EffectList.
+    *   There are no virtuals, every effect type MUST define all of these (with a static Type)
+    *   or the registry fails to compile:
+    *
+    *   static constexpr EffectType Type:   PHOTO_EFFECT or VIDEO_EFFECT, decides if OnUpdate is ever called.
     *
     *   OnApplied:  Occurs when an effect is first activated to handle initial applications of the effect.
     *               This is called only once and is typically used by static photo effects that perform
@@ -51,15 +42,13 @@ public:
     *
     *   OnUpdate:   Typically used by dynamic effects that need to continuously correct over time. Called
     *               every application update to give the Effect a chance to perform dynamic processing.
-    *               Usually the application abstains from calling this on PHOTO_EFFECTs.
+    *               Never called on PHOTO_EFFECTs.
     *
     *   OnRemoved:  Occurs when an Effect is swapped out or removed; allows the Effect to handle its removal.
     *
+    *   OnSetArgs:  Occurs when new arguments were received for the effect. Effects declare an ArgsSchema
+    *               and decode the arguments through it, see EffectArgs.h.
     */
-    virtual void OnApplied() = 0;
-    virtual void OnUpdate(float deltaTime) = 0;
-    virtual void OnRemoved() = 0;
-    virtual void OnSetArgs(EffectArgs& args) = 0;
 
     inline EffectType GetType() const { return m_Type; }
 private:
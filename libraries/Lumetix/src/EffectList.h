@@ -0,0 +1,128 @@
+#ifndef EFFECT_LIST_H
+#define EFFECT_LIST_H
+
+#include "EffectBase.h"
+
+#ifdef __AVR__
+    #include <new.h>
+#else
+    #include <new>
+#endif
+
+/*  Effect List
+*
+*   Compile-time list of effect types. The effect set is declared once as an EffectList, an effect's id
+*   is its index in the list and is known at compile time through EffectIndex.
+*
+*   EffectDispatch expands into a chain of comparisons against constant ids, each calling the matching
+*   effect's methods directly (no vtables, effects have none). The compiler is free to lower the chain into a
+*   jump table. PHOTO_EFFECTs do not generate any update code.
+*/
+template<typename... Ts>
+struct EffectList
+{
+    static constexpr unsigned int Count = sizeof...(Ts);
+};
+
+/* Id of T within the list. Fails to compile if T is not part of the list */
+template<typename T, typename List> struct EffectIndex;
+
+template<typename T, typename... Ts>
+struct EffectIndex<T, EffectList<T, Ts...>>
+{
+    static constexpr unsigned int Value = 0;
+};
+
+template<typename T, typename U, typename... Ts>
+struct EffectIndex<T, EffectList<U, Ts...>>
+{
+    static constexpr unsigned int Value = 1 + EffectIndex<T, EffectList<Ts...>>::Value;
+};
+
+/* Size and alignment of storage able to hold any effect of the list */
+template<typename List> struct EffectStorage;
+
+template<>
+struct EffectStorage<EffectList<>>
+{
+    static constexpr size_t Size = 1;
+    static constexpr size_t Align = 1;
+};
+
+template<typename T, typename... Ts>
+struct EffectStorage<EffectList<T, Ts...>>
+{
+    typedef EffectStorage<EffectList<Ts...>> Next;
+
+    static constexpr size_t Size = sizeof(T) > Next::Size ? sizeof(T) : Next::Size;
+    static constexpr size_t Align = alignof(T) > Next::Align ? alignof(T) : Next::Align;
+};
+
+/* Default construction of effects in place. Specialize for effects that need constructor arguments */
+template<typename T>
+struct EffectConstructor
+{
+    static EffectBase* Construct(void* memory) { return new (memory) T(); }
+};
+
+/* Static dispatch by effect id */
+template<typename List, unsigned int Id = 0> struct EffectDispatch;
+
+template<unsigned int Id>
+struct EffectDispatch<EffectList<>, Id>
+{
+    static EffectBase* Construct(unsigned int, void*)          { return nullptr; }
+    static void Destroy(unsigned int, EffectBase*)              {}
+    static void Applied(unsigned int, EffectBase*)              {}
+    static void Update(unsigned int, EffectBase*, float)        {}
+    static void Removed(unsigned int, EffectBase*)              {}
+    static void SetArgs(unsigned int, EffectBase*, const EffectArgs&) {}
+};
+
+template<typename T, typename... Ts, unsigned int Id>
+struct EffectDispatch<EffectList<T, Ts...>, Id>
+{
+    typedef EffectDispatch<EffectList<Ts...>, Id + 1> Next;
+
+    static EffectBase* Construct(unsigned int id, void* memory)
+    {
+        return (id == Id) ? EffectConstructor<T>::Construct(memory) : Next::Construct(id, memory);
+    }
+
+    static void Destroy(unsigned int id, EffectBase* effect)
+    {
+        if(id == Id)    static_cast<T*>(effect)->~T();
+        else            Next::Destroy(id, effect);
+    }
+
+    static void Applied(unsigned int id, EffectBase* effect)
+    {
+        if(id == Id)    static_cast<T*>(effect)->OnApplied();
+        else            Next::Applied(id, effect);
+    }
+
+    static void Update(unsigned int id, EffectBase* effect, float deltaTime)
+    {
+        if(id != Id)
+        {
+            Next::Update(id, effect, deltaTime);
+        }
+        else if(T::Type == EffectType::VIDEO_EFFECT)
+        {
+            static_cast<T*>(effect)->OnUpdate(deltaTime);
+        }
+    }
+
+    static void Removed(unsigned int id, EffectBase* effect)
+    {
+        if(id == Id)    static_cast<T*>(effect)->OnRemoved();
+        else            Next::Removed(id, effect);
+    }
+
+    static void SetArgs(unsigned int id, EffectBase* effect, const EffectArgs& args)
+    {
+        if(id == Id)    static_cast<T*>(effect)->OnSetArgs(args);
+        else            Next::SetArgs(id, effect, args);
+    }
+};
+#endif // !EFFECT_LIST_H
@@ -1,32 +1,72 @@
 #include "EffectRegistry.h"
 
 #include "Effects/EffectsFwd.h"
+#include "Profiler.h"
+
+/* IntensityGradient is registered as a vertical gradient */
+template<>
+struct EffectConstructor<IntensityGradientEffect>
+{
+    static EffectBase* Construct(void* memory) { return new (memory) IntensityGradientEffect(0, 180, EGradientDirection::VERTICAL); }
+};
+
+typedef EffectDispatch<RegisteredEffects> Dispatch;
+typedef EffectStorage<RegisteredEffects> EffectSlot;
+
+/* Arena slots are sized and aligned for the largest registered effect */
+alignas(EffectSlot::Align) static byte s_EffectArena[MAX_ACTIVE_EFFECTS][EffectSlot::Size];
 
 #define INDEX_NONE -1
 EffectRegistry::EffectRegistry()
     : m_ActiveEffect(INDEX_NONE)
+    , m_UsedSlots(0)
+    , m_NumLayers(0)
+    , m_bCompositeDirty(false)
+    , m_NumRetiring(0)
+    , m_CrossfadeDuration(0.f)
+    , m_CrossfadeTime(0.f)
+    , m_bInterpolatesAfterFade(true)
 {
 }
 
 void EffectRegistry::Init()
 {
-    m_Effects[0] = new ColorCorrectEffect();
-    m_Effects[1] = new PartyEffect();
-    m_Effects[2] = new IntensityGradientEffect(0, 180, EGradientDirection::VERTICAL);
-    m_Effects[3] = new ColorFilterEffect();
-    // ...
-    // ...
+    // Effects are constructed on activation, nothing to allocate up front
+    LOG("Effect arena bytes: "); LOGN(sizeof(s_EffectArena));
 }
 
 void EffectRegistry::Update(float deltaTime)
 {
-    if(m_ActiveEffect == INDEX_NONE || m_ActiveEffect >= GetNumEffects())
-        return;
+    LedPanel& panel = gContext->Panel;
+
+    for(int i = 0; i < m_NumLayers; i++)
+    {
+        EffectLayer& layer = m_Layers[i];
+
+        // Photo effects already rendered their layer when applied, they cost nothing per frame
+        if(layer.Effect->GetType() == EffectType::PHOTO_EFFECT)
+            continue;
+
+        PROFILE_EFFECT_SCOPE(layer.EffectId);
+        panel.BeginLayer(layer.Frame);
+        Dispatch::Update(layer.EffectId, layer.Effect, deltaTime);
+        m_bCompositeDirty |= panel.EndLayer();
+    }
+
+    if(m_NumRetiring > 0)
+    {
+        m_CrossfadeTime += deltaTime;
+        m_bCompositeDirty = true;
+
+        if(m_CrossfadeTime >= m_CrossfadeDuration)
+        {
+            FinishCrossfade();
+        }
+    }
 
-    EffectBase* effect = m_Effects[m_ActiveEffect];
-    if(effect)
+    if(m_bCompositeDirty)
     {
-        effect->OnUpdate(deltaTime);
+        Composite();
     }
 }
 
@@ -37,57 +77,269 @@ bool EffectRegistry::ActivateEffect(unsigned int effectId)
         return false;
     
     // Already active!
-    if(effectId == m_ActiveEffect)
+    if((int)effectId == m_ActiveEffect && (m_NumLayers - m_NumRetiring) == 1)
         return false;
 
-    EffectBase* effect = m_Effects[effectId];
+    // Previous fade is cut short, its outgoing effects are retired right away
+    if(m_NumRetiring > 0)
+    {
+        FinishCrossfade();
+    }
+
+    // Crossfade needs the outgoing effects to keep rendering, and room on the stack for the incoming one
+    const bool bCrossfade = m_CrossfadeDuration > 0.f && m_NumLayers > 0 && m_NumLayers < MAX_ACTIVE_EFFECTS
+                            && FindLayer(effectId) == INDEX_NONE;
     
-    if(!effect)
-        return false;
+    if(!bCrossfade)
+    {
+        // Remove any previous effects if exists
+        ClearEffects();
+        return PushEffect(effectId, 0, EUpdateMode::IGNORE_UNSELECTED);
+    }
 
-    // Remove any previous effect if exists
-    DeactivateEffect();
+    // All current layers become outgoing, incoming layer goes on top of them
+    m_NumRetiring = m_NumLayers;
+    m_CrossfadeTime = 0.f;
 
-    // Assign the new active effect and apply it
-    m_ActiveEffect = effectId;
+    LedPanel& panel = gContext->Panel;
+    if(!PushEffect(effectId, 0, EUpdateMode::IGNORE_UNSELECTED))
+    {
+        m_bInterpolatesAfterFade = panel.bInterpolates;
+        FinishCrossfade();
+        return false;
+    }
 
-    effect->OnApplied();
+    // The fade is our transition, panel interpolation on top of it would only lag behind
+    m_bInterpolatesAfterFade = panel.bInterpolates;
+    panel.bInterpolates = false;
     return true;
 }
 
+void EffectRegistry::SetCrossfadeDuration(float duration)
+{
+    m_CrossfadeDuration = duration;
+}
+
+void EffectRegistry::FinishCrossfade()
+{
+    // Outgoing layers are at the bottom of the stack
+    while(m_NumRetiring > 0)
+    {
+        m_NumRetiring--;
+        RemoveLayer(0);
+    }
+
+    // Restores the incoming effect's preference, whatever the outgoing effects did on removal
+    LedPanel& panel = gContext->Panel;
+    panel.bInterpolates = m_bInterpolatesAfterFade;
+}
+
 bool EffectRegistry::DeactivateEffect()
 {
     if(m_ActiveEffect == INDEX_NONE)
         return false;
 
-    EffectBase* effect = m_Effects[m_ActiveEffect];
+    return RemoveEffect(m_ActiveEffect);
+}
+
+bool EffectRegistry::PushEffect(unsigned int effectId, byte priority, EUpdateMode blendMode)
+{
+    if(effectId >= (unsigned int)GetNumEffects())
+        return false;
+
+    // Already on the stack, or no room left
+    if(FindLayer(effectId) != INDEX_NONE || m_NumLayers == MAX_ACTIVE_EFFECTS)
+        return false;
+
+    byte slot;
+    EffectBase* effect = ConstructEffect(effectId, slot);
     if(!effect)
         return false;
 
-    effect->OnRemoved();
-    m_ActiveEffect = -1;
+    // Insert above every layer of equal or lower priority, outgoing layers always stay at the bottom
+    int layerIdx = m_NumLayers;
+    while(layerIdx > m_NumRetiring && m_Layers[layerIdx - 1].Priority > priority)
+    {
+        m_Layers[layerIdx] = m_Layers[layerIdx - 1];
+        layerIdx--;
+    }
+    m_NumLayers++;
+
+    EffectLayer& layer = m_Layers[layerIdx];
+    layer.EffectId = effectId;
+    layer.Effect = effect;
+    layer.Slot = slot;
+    layer.Priority = priority;
+    layer.BlendMode = blendMode;
+    memset(layer.Frame, 0, sizeof(layer.Frame));
+
+    // Assign the new active effect and apply it
+    m_ActiveEffect = effectId;
+
+    LedPanel& panel = gContext->Panel;
+    panel.BeginLayer(layer.Frame);
+    Dispatch::Applied(effectId, effect);
+    panel.EndLayer();
+
+    m_bCompositeDirty = true;
+    return true;
+}
+
+bool EffectRegistry::RemoveEffect(unsigned int effectId)
+{
+    const int layerIdx = FindLayer(effectId);
+    if(layerIdx == INDEX_NONE)
+        return false;
+
+    RemoveLayer(layerIdx);
+
+    // Fallback to the top of the stack
+    if((int)effectId == m_ActiveEffect)
+    {
+        m_ActiveEffect = (m_NumLayers > 0 ? m_Layers[m_NumLayers - 1].EffectId : INDEX_NONE);
+    }
+
     return true;
 }
 
-void EffectRegistry::NotifyArgsChanged(EffectArgs& args)
+void EffectRegistry::ClearEffects()
+{
+    if(m_NumRetiring > 0)
+    {
+        FinishCrossfade();
+    }
+
+    while(m_NumLayers > 0)
+    {
+        RemoveLayer(m_NumLayers - 1);
+    }
+
+    m_ActiveEffect = INDEX_NONE;
+}
+
+void EffectRegistry::FlushComposite()
+{
+    if(m_bCompositeDirty)
+    {
+        Composite();
+    }
+}
+
+void EffectRegistry::NotifyArgsChanged(const EffectArgs& args)
 {
     // No active effect to notify
     if(m_ActiveEffect == INDEX_NONE || m_ActiveEffect >= GetNumEffects())
         return;
 
+    NotifyArgsChanged(m_ActiveEffect, args);
+}
+
+void EffectRegistry::NotifyArgsChanged(unsigned int effectId, const EffectArgs& args)
+{
     // No argument content
-    if(args.NumArgs == 0)
+    if(args.NumBytes == 0)
+        return;
+
+    const int layerIdx = FindLayer(effectId);
+    if(layerIdx == INDEX_NONE)
         return;
 
-    EffectBase* effect = m_Effects[m_ActiveEffect];
+    // Effects typically re-render on new arguments, so this happens within their layer
+    LedPanel& panel = gContext->Panel;
+    panel.BeginLayer(m_Layers[layerIdx].Frame);
+    Dispatch::SetArgs(effectId, m_Layers[layerIdx].Effect, args);
+    m_bCompositeDirty |= panel.EndLayer();
+}
 
-    if(effect)
+const EffectBase* EffectRegistry::GetActiveEffect() const
+{
+    const int layerIdx = (m_ActiveEffect == INDEX_NONE ? INDEX_NONE : FindLayer(m_ActiveEffect));
+    return (layerIdx == INDEX_NONE ? nullptr : m_Layers[layerIdx].Effect);
+}
+
+int EffectRegistry::FindLayer(unsigned int effectId) const
+{
+    // Outgoing layers are not considered active anymore
+    for(int i = m_NumRetiring; i < m_NumLayers; i++)
     {
-        effect->OnSetArgs(args);
+        if(m_Layers[i].EffectId == (int)effectId)
+            return i;
     }
+
+    return INDEX_NONE;
 }
 
-const EffectBase* EffectRegistry::GetActiveEffect() const
+EffectBase* EffectRegistry::ConstructEffect(unsigned int effectId, byte& outSlot)
+{
+    for(byte slot = 0; slot < MAX_ACTIVE_EFFECTS; slot++)
+    {
+        if(m_UsedSlots & (1 << slot))
+            continue;
+
+        m_UsedSlots |= (1 << slot);
+        outSlot = slot;
+        return Dispatch::Construct(effectId, s_EffectArena[slot]);
+    }
+
+    return nullptr;
+}
+
+void EffectRegistry::DestroyEffect(const EffectLayer& layer)
+{
+    Dispatch::Destroy(layer.EffectId, layer.Effect);
+    m_UsedSlots &= ~(1 << layer.Slot);
+}
+
+void EffectRegistry::RemoveLayer(int layerIdx)
+{
+    EffectLayer& layer = m_Layers[layerIdx];
+
+    LedPanel& panel = gContext->Panel;
+    panel.BeginLayer(layer.Frame);
+    Dispatch::Removed(layer.EffectId, layer.Effect);
+    panel.EndLayer();
+
+    DestroyEffect(layer);
+
+    for(int i = layerIdx; i < m_NumLayers - 1; i++)
+    {
+        m_Layers[i] = m_Layers[i + 1];
+    }
+    m_NumLayers--;
+
+    m_bCompositeDirty = true;
+}
+
+void EffectRegistry::Composite()
 {
-    return (m_ActiveEffect == INDEX_NONE ? nullptr : m_Effects[m_ActiveEffect]);
-}
\ No newline at end of file
+    PROFILE_SUBSYSTEM_SCOPE(EProfileSubsystem::COMPOSITE);
+
+    LedPanel& panel = gContext->Panel;
+
+    panel.BeginComposite();
+
+    int i = 0;
+
+    // Incoming layer may have been removed mid-fade, in which case outgoing layers composite as usual
+    if(m_NumRetiring > 0 && m_NumRetiring < m_NumLayers)
+    {
+        for(; i < m_NumRetiring; i++)
+        {
+            panel.CompositeLayer(m_Layers[i].Frame, m_Layers[i].BlendMode);
+        }
+
+        // Fade from the outgoing result to the bottom incoming layer, layers pushed during the fade blend as usual
+        const uint16_t alpha = (uint16_t)(Clamp(m_CrossfadeTime / m_CrossfadeDuration, 0.f, 1.f) * 256.f);
+        panel.CrossfadeLayer(m_Layers[i].Frame, alpha);
+        i++;
+    }
+
+    for(; i < m_NumLayers; i++)
+    {
+        panel.CompositeLayer(m_Layers[i].Frame, m_Layers[i].BlendMode);
+    }
+
+    panel.EndComposite();
+
+    m_bCompositeDirty = false;
+}
@@ -1,9 +1,60 @@
 #ifndef EFFECT_REGISTRY_H
 #define EFFECT_REGISTRY_H
 
-#include "EffectBase.h"
+#include "EffectList.h"
+#include "Effects/EffectsFwd.h"
 
-#define NUM_EFFECTS 12
+/*  The effect set, declared once. Effect ids are indices in this list, as used by the serial protocol,
+*   so new effects are appended at the end. Use EffectId<T>() rather than raw numbers in code.
+*/
+typedef EffectList<
+    ColorCorrectEffect,         // 0
+    PartyEffect,                // 1
+    IntensityGradientEffect,    // 2
+    ColorFilterEffect,          // 3
+    KeyframeEffect,             // 4
+    NoiseEffect,                // 5
+    LuxControlEffect            // 6
+> RegisteredEffects;
+
+#define NUM_EFFECTS (RegisteredEffects::Count)
+
+template<typename T>
+constexpr unsigned int EffectId() { return EffectIndex<T, RegisteredEffects>::Value; }
+
+/* Maximum number of effects that can run concurrently. Each costs a PanelFrame of RAM */
+#define MAX_ACTIVE_EFFECTS 3
+
+/*  An active effect on the stack. The effect renders into its own frame which is then
+*   blended with the effects below it using the layer's blend mode.
+*/
+struct EffectLayer
+{
+    int EffectId;
+    EffectBase* Effect;     // Constructed in the registry's arena
+    byte Slot;              // Arena slot owned by the effect
+    byte Priority;          // Higher priorities are composited on top
+    EUpdateMode BlendMode;
+    PanelFrame Frame;
+};
+
+/*  Effect Registry
+*
+*   Owns all RegisteredEffects and runs an ordered stack of active effects. Effects are not allocated up front, they are
+*   constructed into a static arena when pushed on the stack and destroyed when removed. The arena holds
+*   MAX_ACTIVE_EFFECTS slots, each sized for the largest registered effect, so RAM tracks the active effects
+*   rather than the size of the catalogue. Effects are called through EffectDispatch, by id, without vtables.
+*
+*   Every update, VIDEO_EFFECTs render into their layer and the stack is composited into a single panel frame.
+*   PHOTO_EFFECTs only render when applied or when their arguments change, and the panel is only re-composited when a layer was actually written to.
+*
+*   ActivateEffect replaces the whole stack with a single effect, PushEffect/RemoveEffect manage layered effects.
+*   The "active" effect is the most recently activated or pushed one, it receives NotifyArgsChanged.
+*
+*   If a crossfade duration is set, ActivateEffect keeps the outgoing effects rendering at the bottom of the stack
+*   and fades the panel from their result to the incoming effect. Outgoing effects are retired once the fade is done.
+*   Panel interpolation is disabled for the duration of the fade, the incoming effect's preference is restored after.
+*/
 class EffectRegistry
 {
 public:
@@ -13,13 +64,47 @@ public:
 
     bool ActivateEffect(unsigned int effectId);
     bool DeactivateEffect();
-    void NotifyArgsChanged(EffectArgs& args);
+    void NotifyArgsChanged(const EffectArgs& args);
+
+    /* Layered effects */
+    bool PushEffect(unsigned int effectId, byte priority, EUpdateMode blendMode = EUpdateMode::ADD);
+    bool RemoveEffect(unsigned int effectId);
+    void ClearEffects();
+    void NotifyArgsChanged(unsigned int effectId, const EffectArgs& args);
+
+    /* Composites any pending layer change right away, rather than on the next Update */
+    void FlushComposite();
+
+    /* Duration in seconds of the fade between effects on ActivateEffect. 0 switches immediately */
+    void SetCrossfadeDuration(float duration);
+    inline bool IsCrossfading() const { return m_NumRetiring > 0; }
 
     inline int GetActiveEffectId() const { return m_ActiveEffect; }
     const EffectBase* GetActiveEffect() const;
     inline constexpr int GetNumEffects() const { return NUM_EFFECTS; }
+    inline int GetNumActiveEffects() const { return m_NumLayers; }
+private:
+    int FindLayer(unsigned int effectId) const;
+    EffectBase* ConstructEffect(unsigned int effectId, byte& outSlot);
+    void DestroyEffect(const EffectLayer& layer);
+    void RemoveLayer(int layerIdx);
+    void Composite();
+    void FinishCrossfade();
 private:
     int m_ActiveEffect;
-    EffectBase* m_Effects[NUM_EFFECTS];
+
+    /* Bitmask of the arena slots in use */
+    byte m_UsedSlots;
+
+    /* Sorted by priority, bottom of the stack first */
+    EffectLayer m_Layers[MAX_ACTIVE_EFFECTS];
+    int m_NumLayers;
+    bool m_bCompositeDirty;
+
+    /* Outgoing layers of a crossfade occupy the bottom of the stack */
+    int m_NumRetiring;
+    float m_CrossfadeDuration;
+    float m_CrossfadeTime;
+    bool m_bInterpolatesAfterFade;
 };
 #endif // !EFFECT_REGISTRY_H
@@ -1,8 +1,10 @@
 #include "ColorCorrectEffect.h"
+#include "../Telemetry.h"
 
 #include "../VariableResponse/ResponseCurves.h"
 
 static const char CALIBRATE_SYMBOL = 's';
+const unsigned long ColorCorrectEffect::s_CalibrationSettleTime = 500;
 const float ColorCorrectEffect::s_DefaultMinResponse = 0.f;
 const float ColorCorrectEffect::s_DefaultMaxResponse = 1.f;
 
@@ -10,27 +12,22 @@ static const float s_DefaultRIntensity = .2f;
 static const float s_DefaultBIntensity = .3f;
 
 ColorCorrectEffect::ColorCorrectEffect()
-    : EffectBase(EffectType::VIDEO_EFFECT)
+    : EffectBase(Type)
     , RBf(1.f)
     , RIntensityMultiplier(1.f)
     , BIntensityMultiplier(1.f)
     , WIntensityMultiplier(0.5f)
-    , WarmResponse(RBf, s_DefaultMinResponse, s_DefaultMaxResponse)
-    , CoolResponse(RBf, s_DefaultMinResponse, s_DefaultMaxResponse)
-    , RedResponse(RBf, s_DefaultMinResponse, s_DefaultMaxResponse)
+    , Responses(RBf, s_DefaultMinResponse, s_DefaultMaxResponse)
+    , m_SampleCursor(0)
+    , m_RBfConditioner(CC_SMOOTHING_SHIFT, CC_HYSTERESIS)
+    , m_CalibrationState(ECalibrationState::IDLE)
+    , m_CalibrationStartTime(0)
+    , m_NumCalibrationSamples(0)
 {
-    // Init Curves...
-    Curve CoolResponseCurve(W_CoolWarmResponse, KARR_LEN(W_CoolWarmResponse));
-    Curve WarmResponseCurve(Y_CoolWarmResponse, KARR_LEN(Y_CoolWarmResponse));
-    Curve RedResponseCurve(R_CCResponse, KARR_LEN(R_CCResponse));
-
-    // Just in case...
-    CoolResponseCurve.Rebuild();
-    WarmResponseCurve.Rebuild();
-
-    CoolResponse.SetResponseCurve(CoolResponseCurve);
-    WarmResponse.SetResponseCurve(WarmResponseCurve);
-    RedResponse.SetResponseCurve(RedResponseCurve);
+    // Baked straight from the flash templates, the keys are never copied to RAM
+    Responses.SetResponseCurve(COOL_RESPONSE, CurveView(W_CoolWarmResponse, KARR_LEN(W_CoolWarmResponse)));
+    Responses.SetResponseCurve(WARM_RESPONSE, CurveView(Y_CoolWarmResponse, KARR_LEN(Y_CoolWarmResponse)));
+    Responses.SetResponseCurve(RED_RESPONSE, CurveView(R_CCResponse, KARR_LEN(R_CCResponse)));
 }
 
 void ColorCorrectEffect::OnApplied()
@@ -40,28 +37,57 @@ void ColorCorrectEffect::OnApplied()
 
 void ColorCorrectEffect::OnUpdate(float deltaTime)
 {
-    RGBSensor& sensor = gContext->RgbSensor;
+    RgbSample sample;
 
-    // Read sensor values (16 bit integers)
-    float red   = sensor.readRed();
-    float green = sensor.readGreen();
-    float blue  = sensor.readBlue();
-    //
-    float REDf      = red / (green + blue);
-    float GREENf    = green / (red + blue);
-    float BLUEf     = blue / (red + green);
+    // Nothing new from the sensor, our previous response still holds
+    if(!gContext->Sampler.ConsumeLatest(m_SampleCursor, sample))
+        return;
 
-    RBf         = REDf / BLUEf;
+    const float rawRBf = ComputeRBf(sample);
 
-    LOG("Rf/Bf: "); LOGN(RBf);
+    if(Telemetry::IsDue(ETelemetryRecord::SENSOR))
+    {
+        const float sum = (float)sample.Red + sample.Green + sample.Blue;
+        TelemetryRecord(ETelemetryRecord::SENSOR)
+            .PutU16(sample.Red).PutU16(sample.Green).PutU16(sample.Blue)
+            .PutQ8_8(sum > 0.f ? sample.Red / sum : 0.f)
+            .PutQ8_8(rawRBf)
+            .Send();
+    }
 
-    float W_response = CoolResponse.GetValue();
-    float Y_response = WarmResponse.GetValue();
-    float R_response = RedResponse.GetValue();
+    // Only respond once the conditioned ratio moved past the hysteresis band, steady light causes no panel writes
+    if(m_RBfConditioner.Push(rawRBf))
+    {
+        RBf = m_RBfConditioner.GetValue();
+        ApplyResponse();
+    }
 
-    LOG("Parameter t = "); LOGN(CoolResponse.DebugGetParameter());
-    LOG("Cool Response Value = "); LOGN(W_response);
-    LOG("Warm Response Value = "); LOGN(Y_response);
+    if(m_CalibrationState != ECalibrationState::IDLE)
+    {
+        UpdateCalibration(sample, rawRBf);
+    }
+}
+
+void ColorCorrectEffect::ApplyResponse()
+{
+    float responses[NUM_RESPONSES];
+    Responses.GetValues(responses);
+
+    float W_response = responses[COOL_RESPONSE];
+    float Y_response = responses[WARM_RESPONSE];
+    float R_response = responses[RED_RESPONSE];
+
+    if(Telemetry::IsDue(ETelemetryRecord::COLOR_RESPONSE))
+    {
+        TelemetryRecord(ETelemetryRecord::COLOR_RESPONSE)
+            .PutQ8_8(RBf)
+            .PutQ8_8(Responses.GetMax())
+            .PutUQ0_16(Responses.DebugGetParameter())
+            .PutUQ0_16(W_response)
+            .PutUQ0_16(Y_response)
+            .PutUQ0_16(R_response)
+            .Send();
+    }
 
     // Proportionally Attenuated Response
     W_response *= BIntensityMultiplier;
@@ -78,7 +104,6 @@ void ColorCorrectEffect::OnUpdate(float deltaTime)
     ledPanel.SetBrightness(ELedColor::RED, ceil(R_response * 255));
     ledPanel.SetBrightness(ELedColor::GREEN, ceil(G_response * 255));
     ledPanel.SetBrightness(ELedColor::BLUE, ceil(B_response * 255));
-
 }
 
 void ColorCorrectEffect::OnRemoved()
@@ -86,48 +111,117 @@ void ColorCorrectEffect::OnRemoved()
 
 }
 
-void ColorCorrectEffect::Calibrate()
+float ColorCorrectEffect::ComputeRBf(const RgbSample& sample)
 {
-    RGBSensor& sensor = gContext->RgbSensor;
-    float RBfAvg = 0;
+    // Sensor values (16 bit integers)
+    float red   = sample.Red;
+    float green = sample.Green;
+    float blue  = sample.Blue;
+    //
+    float REDf      = red / (green + blue);
+    float BLUEf     = blue / (red + green);
+
+    return REDf / BLUEf;
+}
+
+void ColorCorrectEffect::BeginCalibration()
+{
+    m_CalibrationState = ECalibrationState::SETTLING;
+    m_CalibrationStartTime = millis();
+    m_NumCalibrationSamples = 0;
+
+    SendCalibrationTelemetry();
+}
+
+void ColorCorrectEffect::UpdateCalibration(const RgbSample& sample, float rawRBf)
+{
+    // Indicate that we are calibrating. Done after the response, which would otherwise overwrite it.
+    LedPanel& panel = gContext->Panel;
+    panel.SetBrightness(EPanel::TOP, ELedColor::RED, 255);
 
-    for(int i = 0; i < 30; i++) {
-        // Read sensor values (16 bit integers)
-        float red   = sensor.readRed();
-        float green = sensor.readGreen();
-        float blue  = sensor.readBlue();
-        //
-        float REDf      = red / (green + blue);
-        float GREENf    = green / (red + blue);
-        float BLUEf     = blue / (red + green);
-
-        RBfAvg += REDf / BLUEf;
+    if(m_CalibrationState == ECalibrationState::SETTLING)
+    {
+        // Ignore conversions that started before the user had a chance to settle the light
+        if(sample.Timestamp - m_CalibrationStartTime < s_CalibrationSettleTime)
+            return;
+
+        m_CalibrationState = ECalibrationState::COLLECTING;
     }
 
-    RBfAvg /= 30.0;
+    // Insertion sort as we go, keeps the samples ordered for the trimmed mean.
+    // Raw values are used on purpose, the trimmed mean is our filter here.
+    const float rbf = rawRBf;
+    int i = m_NumCalibrationSamples++;
+    while(i > 0 && m_CalibrationSamples[i - 1] > rbf)
+    {
+        m_CalibrationSamples[i] = m_CalibrationSamples[i - 1];
+        i--;
+    }
+    m_CalibrationSamples[i] = rbf;
+
+    if(m_NumCalibrationSamples == CC_CALIBRATION_SAMPLES)
+    {
+        FinishCalibration();
+    }
+    else
+    {
+        SendCalibrationTelemetry();
+    }
+}
+
+void ColorCorrectEffect::FinishCalibration()
+{
+    // Trimmed mean of the middle half, robust against flicker and someone walking past the sensor
+    const int first = CC_CALIBRATION_SAMPLES / 4;
+    const int last = CC_CALIBRATION_SAMPLES - first;
+
+    float RBfAvg = 0;
+    for(int i = first; i < last; i++)
+    {
+        RBfAvg += m_CalibrationSamples[i];
+    }
+    RBfAvg /= (last - first);
 
     float newMin = 0.f;
     float newMax = RBfAvg * 2.f;
 
-    CoolResponse.ResetRange(newMin, newMax);
-    WarmResponse.ResetRange(newMin, newMax);
+    // All responses share the range, the panel never sees a half calibrated response
+    Responses.ResetRange(newMin, newMax);
+
+    m_CalibrationState = ECalibrationState::IDLE;
+
+    // New ranges change the response even if RBf did not, this also clears the calibration indicator
+    ApplyResponse();
+
+    SendCalibrationTelemetry();
+}
+
+void ColorCorrectEffect::SendCalibrationTelemetry() const
+{
+    if(Telemetry::IsEnabled())
+    {
+        TelemetryRecord(ETelemetryRecord::CALIBRATION)
+            .PutU8(static_cast<byte>(m_CalibrationState))
+            .PutU8(m_NumCalibrationSamples)
+            .PutQ8_8(Responses.GetMax())
+            .Send();
+    }
+}
+
+void ColorCorrectEffect::SetConditioning(byte smoothingShift, float hysteresis)
+{
+    m_RBfConditioner.SetSmoothing(smoothingShift);
+    m_RBfConditioner.SetHysteresis(hysteresis);
 }
 
-void ColorCorrectEffect::OnSetArgs(EffectArgs& args)
+/* (char calibrateSymbol) */
+typedef ArgSchema<Arg<char, CALIBRATE_SYMBOL, CALIBRATE_SYMBOL>> ArgsSchema;
+
+void ColorCorrectEffect::OnSetArgs(const EffectArgs& args)
 {
-    // Expecting 1 argument, telling us the new average RBf value OR a symbol for calibration
-    if(args.NumArgs == 1)
+    char symbol;
+    if(ArgsSchema::Decode(args, symbol))
     {
-        if(args.ArgBuffer.GetNumBytes() == sizeof(char))
-        {
-            char c = args.ArgBuffer.GetChar();
-            if(c == CALIBRATE_SYMBOL)
-            {
-                LedPanel& panel = gContext->Panel;
-                panel.SetBrightness(EPanel::TOP, ELedColor::RED, 255);
-                delay(500);
-                Calibrate();
-            }
-        }
+        BeginCalibration();
     }
-}
\ No newline at end of file
+}
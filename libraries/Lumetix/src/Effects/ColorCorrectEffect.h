@@ -2,20 +2,47 @@
 #define COLOR_CORRECT_EFFECT_H
 
 #include "../EffectBase.h"
-#include "../../../VariableResponse/VariableResponse.h"
+#include "../SignalConditioner.h"
+#include "../../../VariableResponse/ResponseBank.h"
 
 #define CC_RED_ATTENUATION
+
+/* Number of fresh sensor samples collected per calibration */
+#define CC_CALIBRATION_SAMPLES 12
+
+/* Default conditioning of the sensor ratio. See SignalConditioner */
+#define CC_SMOOTHING_SHIFT 2
+#define CC_HYSTERESIS 0.05f
+
 class ColorCorrectEffect : public EffectBase
 {
 public:
+    static constexpr EffectType Type = EffectType::VIDEO_EFFECT;
+
     ColorCorrectEffect();
 
-    virtual void OnApplied() override;
-    virtual void OnUpdate(float deltaTime) override;
-    virtual void OnRemoved() override;
-    virtual void OnSetArgs(EffectArgs& args) override;
+    void OnApplied();
+    void OnUpdate(float deltaTime);
+    void OnRemoved();
+    void OnSetArgs(const EffectArgs& args);
+
+    /* Panel targets are only updated once the smoothed sensor ratio moves by more than the hysteresis */
+    void SetConditioning(byte smoothingShift, float hysteresis);
 protected:
-    void Calibrate();
+    /* Pushes the response to the current RBf to the panel */
+    void ApplyResponse();
+
+    /*  Calibration runs incrementally, one fresh sensor sample per update, so the panel keeps rendering.
+    *   The response ranges are only replaced once all samples have been collected.
+    */
+    void BeginCalibration();
+    void UpdateCalibration(const RgbSample& sample, float rawRBf);
+    void FinishCalibration();
+
+    /* Calibration record: state (0 idle/done, 1 settling, 2 collecting), samples so far and the current range */
+    void SendCalibrationTelemetry() const;
+
+    static float ComputeRBf(const RgbSample& sample);
 protected:
     float RBf;
 
@@ -26,8 +53,34 @@ private:
     static const float s_DefaultMinResponse;
     static const float s_DefaultMaxResponse;
 
-    VariableResponse WarmResponse; // Response of warm colors to a cool input
-    VariableResponse CoolResponse; // Response of cool colors to a warm input
-    VariableResponse RedResponse;
+    /* Channels of Responses, all three follow RBf over the calibrated range */
+    enum EResponse : byte
+    {
+        COOL_RESPONSE,  // Response of cool colors to a warm input
+        WARM_RESPONSE,  // Response of warm colors to a cool input
+        RED_RESPONSE,
+        NUM_RESPONSES
+    };
+
+    ResponseBank<NUM_RESPONSES> Responses;
+
+    /* Sequence of the last sensor sample we responded to */
+    uint16_t m_SampleCursor;
+
+    SignalConditioner m_RBfConditioner;
+
+    enum class ECalibrationState : byte
+    {
+        IDLE,
+        SETTLING,   // Waiting for the light to settle after the request
+        COLLECTING
+    };
+
+    ECalibrationState m_CalibrationState;
+    unsigned long m_CalibrationStartTime;
+    byte m_NumCalibrationSamples;
+    float m_CalibrationSamples[CC_CALIBRATION_SAMPLES]; // Sorted
+
+    static const unsigned long s_CalibrationSettleTime; // ms
 };
 #endif // !COLOR_CORRECT_EFFECT_H
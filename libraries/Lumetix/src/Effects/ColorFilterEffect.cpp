@@ -1,7 +1,7 @@
 #include "ColorFilterEffect.h"
 
 ColorFilterEffect::ColorFilterEffect()
-    : EffectBase(EffectType::PHOTO_EFFECT)
+    : EffectBase(Type)
     , m_ActiveFilter(FilterType::TYPE10)
     , m_StrobeFrequency(0.f)
     , m_StrobeOffset(0.f)
@@ -45,13 +45,13 @@ void ColorFilterEffect::OnRemoved()
     panel.bInterpolates = m_WasInterpEnabled;
 }
 
-void ColorFilterEffect::OnSetArgs(EffectArgs& args)
+/* (byte filterType) */
+typedef ArgSchema<Arg<byte, ColorFilterEffect::BLUE, ColorFilterEffect::TYPE14>> ArgsSchema;
+
+void ColorFilterEffect::OnSetArgs(const EffectArgs& args)
 {
-    if(args.NumArgs == 1)
+    if(ArgsSchema::Decode(args, m_ActiveFilter))
     {
-        byte filterType = args.ArgBuffer.GetByte();
-        
-        m_ActiveFilter = static_cast<FilterType>(filterType);
         OnApplied();
     }
 }
@@ -5,6 +5,8 @@
 class ColorFilterEffect : public EffectBase
 {
 public:
+    static constexpr EffectType Type = EffectType::PHOTO_EFFECT;
+
     ColorFilterEffect();
 
     enum FilterType : short
@@ -24,10 +26,10 @@ public:
         TYPE14 = 14
     };
 
-    virtual void OnApplied() override;
-    virtual void OnUpdate(float deltaTime) override;
-    virtual void OnRemoved() override;
-    virtual void OnSetArgs(EffectArgs& args) override;
+    void OnApplied();
+    void OnUpdate(float deltaTime);
+    void OnRemoved();
+    void OnSetArgs(const EffectArgs& args);
 protected:
     void ApplyFilter(byte brightness);
 private:
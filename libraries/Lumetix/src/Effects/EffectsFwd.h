@@ -2,4 +2,7 @@
 #include "ColorCorrectEffect.h"
 #include "IntensityGradientEffect.h"
 #include "PartyEffect.h"
-#include "ColorFilterEffect.h"
\ No newline at end of file
+#include "ColorFilterEffect.h"
+#include "KeyframeEffect.h"
+#include "NoiseEffect.h"
+#include "LuxControlEffect.h"
\ No newline at end of file
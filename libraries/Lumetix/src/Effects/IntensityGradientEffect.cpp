@@ -3,7 +3,7 @@
 #include "Context.h"
 
 IntensityGradientEffect::IntensityGradientEffect(byte intensityA, byte intensityB, EGradientDirection dir)
-    : EffectBase(EffectType::PHOTO_EFFECT)
+    : EffectBase(Type)
     , m_Dir(dir)
     , m_IntensityA(intensityA)
     , m_IntensityB(intensityB)
@@ -77,24 +77,17 @@ void IntensityGradientEffect::OnRemoved()
 
 }
 
-void IntensityGradientEffect::OnSetArgs(EffectArgs& args)
+/* (byte intensityA, byte intensityB, byte dir) - any nonzero dir is vertical */
+typedef ArgSchema<Arg<byte, 0, 255>, Arg<byte, 0, 255>, Arg<byte, 0, 255>> ArgsSchema;
+
+void IntensityGradientEffect::OnSetArgs(const EffectArgs& args)
 {
-    /* Expecting arguments of type (byte, byte, byte) */
-    if(args.NumArgs == 3)
+    byte dir;
+    if(ArgsSchema::Decode(args, m_IntensityA, m_IntensityB, dir))
     {
-        ByteBuffer buffer = args.ArgBuffer;
-        if(buffer.GetNumBytes() == 3) // 3 bytes
-        {
-            byte intensityA = buffer.GetByte();
-            byte intensityB = buffer.GetByte();
-            byte dir = buffer.GetByte();
- 
-            m_IntensityA = intensityA;
-            m_IntensityB = intensityB;
-            m_Dir = (dir == 0 ? EGradientDirection::HORIZONTAL : EGradientDirection::VERTICAL);
-
-            // Refresh
-            OnApplied();
-        }
+        m_Dir = (dir == 0 ? EGradientDirection::HORIZONTAL : EGradientDirection::VERTICAL);
+
+        // Refresh
+        OnApplied();
     }
-}
\ No newline at end of file
+}
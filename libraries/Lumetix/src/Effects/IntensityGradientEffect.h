@@ -6,12 +6,14 @@
 class IntensityGradientEffect : public EffectBase
 {
 public:
+    static constexpr EffectType Type = EffectType::PHOTO_EFFECT;
+
     IntensityGradientEffect(byte intensityA, byte intensityB, EGradientDirection dir = EGradientDirection::HORIZONTAL);
 
-    virtual void OnApplied() override;
-    virtual void OnUpdate(float deltaTime) override;
-    virtual void OnRemoved() override;
-    virtual void OnSetArgs(EffectArgs& args) override;
+    void OnApplied();
+    void OnUpdate(float deltaTime);
+    void OnRemoved();
+    void OnSetArgs(const EffectArgs& args);
 
 private:
     void ApplyVerticalGradient();
@@ -0,0 +1,47 @@
+#ifndef KEYFRAME_ANIMATIONS_H
+#define KEYFRAME_ANIMATIONS_H
+
+#include "KeyframeEffect.h"
+
+/*  Pre-authored animations for the KeyframeEffect, stored in flash.
+*
+*   Each frame starts with its hold time, followed by ops that are applied against the previous frame
+*   until all NUM_LEDS LEDs are covered. The first frame is applied against an all-off panel.
+*   LEDs are indexed panel by panel (Top, Right, Bottom, Left), 16 channels each.
+*
+*   Only include this in a single translation unit, the arrays are static.
+*/
+
+/* All LEDs breathing together */
+static const uint8_t Anim_Pulse[] PROGMEM =
+{
+    KF_HOLD(120), KF_FILL(64), 40,
+    KF_HOLD(120), KF_FILL(64), 120,
+    KF_HOLD(120), KF_FILL(64), 255,
+    KF_HOLD(120), KF_FILL(64), 120
+};
+
+/* Alternate between the top/bottom and left/right panels */
+static const uint8_t Anim_Alternate[] PROGMEM =
+{
+    KF_HOLD(250), KF_FILL(16), 200, KF_SKIP(16), KF_FILL(16), 200, KF_SKIP(16),
+    KF_HOLD(250), KF_FILL(16), 0, KF_FILL(16), 200, KF_FILL(16), 0, KF_FILL(16), 200
+};
+
+/* A few sparse twinkles, mostly unchanged LEDs between frames */
+static const uint8_t Anim_Twinkle[] PROGMEM =
+{
+    KF_HOLD(80), KF_SKIP(3), KF_LITERAL(2), 255, 128, KF_SKIP(30), KF_LITERAL(1), 200, KF_SKIP(28),
+    KF_HOLD(80), KF_SKIP(3), KF_LITERAL(2), 0, 255, KF_SKIP(20), KF_LITERAL(1), 180, KF_SKIP(9), KF_LITERAL(1), 0, KF_SKIP(28),
+    KF_HOLD(80), KF_SKIP(4), KF_LITERAL(1), 0, KF_SKIP(20), KF_LITERAL(1), 0, KF_SKIP(38)
+};
+
+static const KeyframeAnimation s_KeyframeAnimations[] =
+{
+    { Anim_Pulse,       4 },
+    { Anim_Alternate,   2 },
+    { Anim_Twinkle,     3 }
+};
+
+#define NUM_KEYFRAME_ANIMATIONS (sizeof(s_KeyframeAnimations)/sizeof(KeyframeAnimation))
+#endif // !KEYFRAME_ANIMATIONS_H
@@ -0,0 +1,139 @@
+#include "KeyframeEffect.h"
+
+#include "KeyframeAnimations.h"
+
+#define KF_OP_MASK      0xC0
+#define KF_OP_LITERAL   0x80
+#define KF_OP_FILL      0xC0
+
+KeyframeEffect::KeyframeEffect(byte animation, bool bLoops)
+    : EffectBase(Type)
+    , m_Animation(nullptr)
+    , m_FrameIdx(0)
+    , m_ReadPos(0)
+    , m_HoldTime(0)
+    , m_ElapsedTime(0.f)
+    , m_bLoops(bLoops)
+{
+    SetAnimation(animation, bLoops);
+}
+
+void KeyframeEffect::OnApplied()
+{
+    Restart();
+}
+
+void KeyframeEffect::OnUpdate(float deltaTime)
+{
+    m_ElapsedTime += deltaTime * 1000.f;
+
+    if(m_ElapsedTime < m_HoldTime)
+        return;
+
+    if(m_FrameIdx == m_Animation->NumFrames)
+    {
+        // Last frame stays up for good
+        if(!m_bLoops)
+            return;
+
+        Restart();
+        return;
+    }
+
+    // Carry the overshoot over so long shows don't drift
+    m_ElapsedTime -= m_HoldTime;
+    DecodeNextFrame();
+}
+
+void KeyframeEffect::OnRemoved()
+{
+
+}
+
+/* (byte animation, [byte loops]) */
+typedef ArgSchema<Arg<byte, 0, NUM_KEYFRAME_ANIMATIONS - 1>, OptionalArg<byte, 0, 1, 1>> ArgsSchema;
+
+void KeyframeEffect::OnSetArgs(const EffectArgs& args)
+{
+    byte animation;
+    bool bLoops;
+    if(ArgsSchema::Decode(args, animation, bLoops))
+    {
+        SetAnimation(animation, bLoops);
+        Restart();
+    }
+}
+
+void KeyframeEffect::SetAnimation(byte animation, bool bLoops)
+{
+    if(animation >= NUM_KEYFRAME_ANIMATIONS)
+    {
+        animation = 0;
+    }
+
+    m_Animation = &s_KeyframeAnimations[animation];
+    m_bLoops = bLoops;
+}
+
+void KeyframeEffect::Restart()
+{
+    // The first frame is encoded against an all-off panel
+    LedPanel& panel = gContext->Panel;
+    panel.TurnOff();
+
+    m_FrameIdx = 0;
+    m_ReadPos = 0;
+    m_ElapsedTime = 0.f;
+
+    DecodeNextFrame();
+}
+
+void KeyframeEffect::DecodeNextFrame()
+{
+    const uint8_t* data = m_Animation->Data + m_ReadPos;
+
+    m_HoldTime = pgm_read_byte(data) | (pgm_read_byte(data + 1) << 8);
+    data += 2;
+
+    LedPanel& panel = gContext->Panel;
+    byte* targets = panel.EditTargets();
+
+    int led = 0;
+    while(led < NUM_LEDS)
+    {
+        const byte op = pgm_read_byte(data++);
+
+        // Clamped so that a badly authored frame can't write past the panel
+        int count = (op & KF_OP_LITERAL) ? (op & ~KF_OP_MASK) + 1 : op + 1;
+        if(led + count > NUM_LEDS)
+        {
+            count = NUM_LEDS - led;
+        }
+
+        switch(op & KF_OP_MASK)
+        {
+            case KF_OP_LITERAL:
+            {
+                for(int i = 0; i < count; i++)
+                {
+                    targets[led + i] = pgm_read_byte(data++);
+                }
+            }
+            break;
+
+            case KF_OP_FILL:
+            {
+                memset(&targets[led], pgm_read_byte(data++), count);
+            }
+            break;
+
+            // Skip
+            default: break;
+        }
+
+        led += count;
+    }
+
+    m_ReadPos = data - m_Animation->Data;
+    m_FrameIdx++;
+}
@@ -0,0 +1,53 @@
+#ifndef KEYFRAME_EFFECT_H
+#define KEYFRAME_EFFECT_H
+
+#include "../EffectBase.h"
+
+/*  Keyframe encoding
+*
+*   A frame is its hold time in ms (little endian uint16), followed by ops applied against the previous frame:
+*   KF_SKIP:    Leaves the next n LEDs unchanged, n in [1, 128]
+*   KF_LITERAL: Sets the next n LEDs to the n values that follow, n in [1, 64]
+*   KF_FILL:    Sets the next n LEDs to the single value that follows, n in [1, 64]
+*/
+#define KF_HOLD(ms)     ((ms) & 0xFF), (((ms) >> 8) & 0xFF)
+#define KF_SKIP(n)      (0x00 | ((n) - 1))
+#define KF_LITERAL(n)   (0x80 | ((n) - 1))
+#define KF_FILL(n)      (0xC0 | ((n) - 1))
+
+struct KeyframeAnimation
+{
+    const uint8_t* Data; // PROGMEM
+    uint16_t NumFrames;
+};
+
+/*  Plays back pre-authored animations stored in flash (see KeyframeAnimations.h)
+*
+*   Frames are delta compressed against the previous frame, and decoded straight into the panel targets
+*   once the hold time of the current frame elapsed. Only a single frame is decoded per update.
+*/
+class KeyframeEffect : public EffectBase
+{
+public:
+    static constexpr EffectType Type = EffectType::VIDEO_EFFECT;
+
+    KeyframeEffect(byte animation = 0, bool bLoops = true);
+
+    void OnApplied();
+    void OnUpdate(float deltaTime);
+    void OnRemoved();
+    void OnSetArgs(const EffectArgs& args);
+
+    void SetAnimation(byte animation, bool bLoops);
+private:
+    void Restart();
+    void DecodeNextFrame();
+private:
+    const KeyframeAnimation* m_Animation;
+    uint16_t m_FrameIdx;    // Index of the next frame to decode
+    uint16_t m_ReadPos;     // Offset of the next frame in the animation data
+    uint16_t m_HoldTime;    // ms, of the frame currently displayed
+    float m_ElapsedTime;    // ms
+    bool m_bLoops;
+};
+#endif // !KEYFRAME_EFFECT_H
@@ -0,0 +1,88 @@
+#include "LuxControlEffect.h"
+
+LuxControlEffect::LuxControlEffect(uint16_t targetLux, uint16_t targetRatio)
+    : EffectBase(Type)
+    , m_TargetLux(targetLux)
+    , m_TargetRatio(targetRatio)
+    , m_LuxController(LUX_KP, LUX_KI, 0, 255, LUX_MAX_STEP)
+    , m_RatioController(RATIO_KP, RATIO_KI, -128, 128, RATIO_MAX_STEP)
+    , m_SampleCursor(0)
+{
+}
+
+void LuxControlEffect::OnApplied()
+{
+    // Start from a dark, neutral panel and let the loop ramp up
+    m_LuxController.Reset(0);
+    m_RatioController.Reset(0);
+
+    // Only respond to samples converted after we took over the panel
+    m_SampleCursor = gContext->Sampler.GetSequence();
+
+    ApplyOutput();
+}
+
+void LuxControlEffect::OnUpdate(float deltaTime)
+{
+    RgbSample sample;
+
+    // Controllers run at the sensor rate, nothing to do until a new conversion arrives
+    if(!gContext->Sampler.ConsumeLatest(m_SampleCursor, sample))
+        return;
+
+    // Errors are scaled down to keep the controllers within 16 bits
+    const int32_t luxError = ((int32_t)m_TargetLux - (int32_t)sample.Green) >> 4;
+
+    uint32_t ratio = ((uint32_t)sample.Red << 8) / (sample.Blue > 0 ? sample.Blue : 1);
+    if(ratio > 0x7FFF)
+    {
+        ratio = 0x7FFF;
+    }
+    const int32_t ratioError = (int32_t)m_TargetRatio - (int32_t)ratio;
+
+    m_LuxController.Step((int16_t)luxError);
+    m_RatioController.Step((int16_t)constrain(ratioError, -32767L, 32767L));
+
+    ApplyOutput();
+}
+
+void LuxControlEffect::OnRemoved()
+{
+
+}
+
+/* (byte lux, byte ratio), where lux is in units of 64 counts and ratio is Q4.4 */
+typedef ArgSchema<Arg<byte, 0, 255>, Arg<byte, 0, 255>> ArgsSchema;
+
+void LuxControlEffect::OnSetArgs(const EffectArgs& args)
+{
+    uint16_t lux;
+    uint16_t ratio;
+    if(ArgsSchema::Decode(args, lux, ratio))
+    {
+        SetTarget(lux << 6, ratio << 4);
+    }
+}
+
+void LuxControlEffect::SetTarget(uint16_t targetLux, uint16_t targetRatio)
+{
+    m_TargetLux = targetLux;
+    m_TargetRatio = targetRatio;
+}
+
+void LuxControlEffect::ApplyOutput()
+{
+    const int16_t output = m_LuxController.GetOutput();
+    const int16_t balance = m_RatioController.GetOutput();
+
+    // Split the output between warm and cool LEDs, both equal to the output when balanced
+    const int32_t warm = constrain(((int32_t)output * (128 + balance)) >> 7, 0L, 255L);
+    const int32_t cool = constrain(((int32_t)output * (128 - balance)) >> 7, 0L, 255L);
+
+    LedPanel& panel = gContext->Panel;
+    panel.SetBrightness(ELedColor::YELLOW, warm);
+    panel.SetBrightness(ELedColor::RED, warm);
+    panel.SetBrightness(ELedColor::WHITE, cool);
+    panel.SetBrightness(ELedColor::BLUE, cool);
+    panel.SetBrightness(ELedColor::GREEN, min(warm, cool));
+}
@@ -0,0 +1,55 @@
+#ifndef LUX_CONTROL_EFFECT_H
+#define LUX_CONTROL_EFFECT_H
+
+#include "../EffectBase.h"
+#include "../PIController.h"
+
+/*  Closed-loop counterpart to the ColorCorrectEffect
+*
+*   Rather than mapping the sensor through response curves, this effect measures the light that actually
+*   reaches the sensor and adjusts the panel to hold a target illuminance (green channel counts, which
+*   is closest to the eye's response) and a target red/blue ratio.
+*
+*   Two fixed-point PI controllers run once per fresh sensor sample:
+*   - Illuminance: drives the overall panel output [0, 255]
+*   - Ratio: drives the warm/cool balance [-128, 128], positive being warmer
+*
+*   The panel targets are only written on new samples, and the LedPanel interpolates towards them at its
+*   own rate. With the default gains and a plant gain of 0.5 to 2 error units per output unit, the output
+*   settles within ~30 samples, rate limiting bounds any single step to LUX_MAX_STEP.
+*/
+#define LUX_KP 32   // Q8.8
+#define LUX_KI 96   // Q8.8
+#define LUX_MAX_STEP 32
+
+#define RATIO_KP 32 // Q8.8
+#define RATIO_KI 96 // Q8.8
+#define RATIO_MAX_STEP 16
+
+class LuxControlEffect : public EffectBase
+{
+public:
+    static constexpr EffectType Type = EffectType::VIDEO_EFFECT;
+
+    LuxControlEffect(uint16_t targetLux = 1024, uint16_t targetRatio = 256);
+
+    void OnApplied();
+    void OnUpdate(float deltaTime);
+    void OnRemoved();
+    void OnSetArgs(const EffectArgs& args);
+
+    /* Target ratio is red/blue in Q8.8 */
+    void SetTarget(uint16_t targetLux, uint16_t targetRatio);
+private:
+    void ApplyOutput();
+private:
+    uint16_t m_TargetLux;   // Sensor counts
+    uint16_t m_TargetRatio; // Q8.8
+
+    PIController m_LuxController;
+    PIController m_RatioController;
+
+    /* Sequence of the last sensor sample we responded to */
+    uint16_t m_SampleCursor;
+};
+#endif // !LUX_CONTROL_EFFECT_H
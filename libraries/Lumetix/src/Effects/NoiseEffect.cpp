@@ -0,0 +1,172 @@
+#include "NoiseEffect.h"
+
+/* Lattice values, a shuffle of [0, 255] that also serves as our hash */
+static const uint8_t s_Permutation[256] PROGMEM =
+{
+    181,   1, 179, 217, 161,  25, 228,  36,  81, 234, 229, 120, 231, 131,  68, 197,
+     71, 232, 244,  29, 123, 157, 137,  23,  96,  66, 128, 159, 186, 238,  75, 150,
+     62,  57,   9, 245,  94,  21,  34,  22, 136, 151,  88,  19, 143, 222,   7,  77,
+     95, 189,  83,  37, 107,   2, 215, 174, 160, 239, 208,  31, 113,  59,  99, 252,
+    164,   0, 225, 132, 139, 212,  35, 192, 130, 125,  74,  56, 121, 105, 122, 200,
+     40,  87, 227,  55, 119, 241, 127,  69, 236,   5,  41, 141, 153, 247,  60, 191,
+    106,  53, 101,  97, 114, 218, 111, 251, 155,  28, 170,  32,  70, 190, 166, 180,
+     61, 148,  24, 243,  91, 144,  76,  82,  86,  84,  45, 182,   8,  48,  44, 118,
+     14,  39,  73, 206,  10, 224, 109,  38, 220,  64, 112,  49,  20, 177, 209,  15,
+     33, 250, 201,  65, 226, 237, 214, 138, 124, 133,   6, 116, 253, 126,  12,  47,
+    185, 196, 135,  46, 175,  54, 242, 165, 142, 193, 199,  58, 254, 110, 248, 156,
+      3, 207, 145, 115, 183,  72,  26, 184,  50, 230, 216, 172,  13, 195, 167, 104,
+     18,  11, 147, 158, 134, 163,  17, 140,  51,  67, 219, 249, 154, 176, 173,  80,
+    203,  43,  63, 117,  30, 152,  90, 213,   4, 169,  79, 204, 188, 205, 223, 103,
+     89, 171, 240, 129,  16, 102, 246, 210, 108,  27,  93, 233, 221, 168, 194,  52,
+    178, 100,  78, 235,  92, 202, 162,  98,  85, 211, 198,  42, 255, 149, 146, 187
+};
+
+static inline byte Hash(byte x, byte y, byte z)
+{
+    return pgm_read_byte(&s_Permutation[(byte)(pgm_read_byte(&s_Permutation[(byte)(pgm_read_byte(&s_Permutation[x]) + y)]) + z)]);
+}
+
+/* Smoothstep 3f^2 - 2f^3 in Q0.8 */
+static inline byte Fade(byte f)
+{
+    // Split up as 3f^2 - 2f^2*f so that intermediates fit 16 bits
+    const uint16_t f2 = ((uint16_t)f * f) >> 8;
+    const uint16_t s = 3 * f2 - ((f2 * f) >> 7);
+    return s > 255 ? 255 : s;
+}
+
+/* Lerp with t in Q0.8. t loses a bit so that the product fits 16 bits */
+static inline byte Lerp8(byte a, byte b, byte t)
+{
+    return a + ((((int16_t)b - a) * (t >> 1)) >> 7);
+}
+
+/* Position of an LED on the frame formed by the panels, in an 18x18 grid */
+static inline void GetLedPosition(int panel, int channel, byte& x, byte& y)
+{
+    const byte pos = PhysicalMapping[channel];
+
+    switch(panel)
+    {
+        case EPanel::TOP:       x = 1 + pos;    y = 0;          break;
+        case EPanel::RIGHT:     x = 17;         y = 1 + pos;    break;
+        case EPanel::BOTTOM:    x = 16 - pos;   y = 17;         break;
+        default:                x = 0;          y = 16 - pos;   break;
+    }
+}
+
+NoiseEffect::NoiseEffect(byte speed, byte scale, byte brightness)
+    : EffectBase(Type)
+    , m_Speed(speed)
+    , m_Scale(scale)
+    , m_Brightness(brightness)
+    , m_NumOctaves(NOISE_MAX_OCTAVES)
+    , m_Time(0)
+    , m_TimeRemainder(0.f)
+    , m_ElapsedTime(0.f)
+    , m_FrameMicros(0)
+{
+}
+
+void NoiseEffect::OnApplied()
+{
+    m_ElapsedTime = 0.f;
+    Render();
+}
+
+void NoiseEffect::OnUpdate(float deltaTime)
+{
+    // Advance time in fixed point, keeping the fractional part so slow speeds still move
+    m_TimeRemainder += deltaTime * m_Speed * 16.f;
+    const uint16_t step = (uint16_t)m_TimeRemainder;
+    m_Time += step;
+    m_TimeRemainder -= step;
+
+    m_ElapsedTime += deltaTime * 1000.f;
+    if(m_ElapsedTime < NOISE_FRAME_INTERVAL)
+        return;
+
+    m_ElapsedTime = 0.f;
+    Render();
+}
+
+void NoiseEffect::OnRemoved()
+{
+
+}
+
+/* (byte speed, byte scale, byte brightness) */
+typedef ArgSchema<Arg<byte, 0, 255>, Arg<byte, 0, 255>, Arg<byte, 0, 255>> ArgsSchema;
+
+void NoiseEffect::OnSetArgs(const EffectArgs& args)
+{
+    if(ArgsSchema::Decode(args, m_Speed, m_Scale, m_Brightness))
+    {
+        Render();
+    }
+}
+
+void NoiseEffect::Render()
+{
+    const unsigned long start = micros();
+
+    LedPanel& panel = gContext->Panel;
+    byte* targets = panel.EditTargets();
+
+    for(int p = 0; p < EPanel::MAX_VAL; p++)
+    {
+        for(int channel = 0; channel < NUM_CHANNELS; channel++)
+        {
+            byte x, y;
+            GetLedPosition(p, channel, x, y);
+
+            const uint16_t fx = x * m_Scale;
+            const uint16_t fy = y * m_Scale;
+
+            // Neighbouring channels are different colors, offsetting them in time makes the colors drift apart
+            const uint16_t fz = m_Time + ((channel & 3) << 6);
+
+            uint16_t value = Noise(fx, fy, fz);
+            if(m_NumOctaves > 1)
+            {
+                // Second octave at twice the frequency and half the weight
+                value = (value * 2 + Noise(fx << 1, fy << 1, fz + (fz >> 1))) / 3;
+            }
+
+            targets[p * NUM_CHANNELS + channel] = (value * m_Brightness) >> 8;
+        }
+    }
+
+    m_FrameMicros = micros() - start;
+
+    // Stay within budget, and recover the detail once there is room again
+    if(m_FrameMicros > NOISE_FRAME_BUDGET && m_NumOctaves > 1)
+    {
+        m_NumOctaves--;
+    }
+    else if(m_FrameMicros * 2 * (m_NumOctaves + 1) < NOISE_FRAME_BUDGET * m_NumOctaves && m_NumOctaves < NOISE_MAX_OCTAVES)
+    {
+        m_NumOctaves++;
+    }
+
+    LOG("Noise frame us: "); LOGN(m_FrameMicros);
+}
+
+byte NoiseEffect::Noise(uint16_t x, uint16_t y, uint16_t z)
+{
+    const byte ix = x >> 8;
+    const byte iy = y >> 8;
+    const byte iz = z >> 8;
+
+    const byte u = Fade(x & 0xFF);
+    const byte v = Fade(y & 0xFF);
+    const byte w = Fade(z & 0xFF);
+
+    // Trilinear interpolation of the 8 lattice corners
+    const byte x00 = Lerp8(Hash(ix, iy, iz),         Hash(ix + 1, iy, iz),         u);
+    const byte x10 = Lerp8(Hash(ix, iy + 1, iz),     Hash(ix + 1, iy + 1, iz),     u);
+    const byte x01 = Lerp8(Hash(ix, iy, iz + 1),     Hash(ix + 1, iy, iz + 1),     u);
+    const byte x11 = Lerp8(Hash(ix, iy + 1, iz + 1), Hash(ix + 1, iy + 1, iz + 1), u);
+
+    return Lerp8(Lerp8(x00, x10, v), Lerp8(x01, x11, v), w);
+}
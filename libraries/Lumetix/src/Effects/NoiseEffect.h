@@ -0,0 +1,46 @@
+#ifndef NOISE_EFFECT_H
+#define NOISE_EFFECT_H
+
+#include "../EffectBase.h"
+
+/*  Procedural "ambient" effect evaluating 3D value noise over the LED positions, with time as the third axis.
+*
+*   Everything is evaluated in fixed point (Q8.8 lattice coordinates, 8 bit values), and all 64 LEDs are
+*   written to the panel in a single batch. Rendering is capped to NOISE_FRAME_INTERVAL, and the number of
+*   octaves drops whenever the measured render time goes over NOISE_FRAME_BUDGET.
+*/
+#define NOISE_FRAME_INTERVAL 33     // ms
+#define NOISE_FRAME_BUDGET 3000     // us
+#define NOISE_MAX_OCTAVES 2
+
+class NoiseEffect : public EffectBase
+{
+public:
+    static constexpr EffectType Type = EffectType::VIDEO_EFFECT;
+
+    NoiseEffect(byte speed = 64, byte scale = 48, byte brightness = 200);
+
+    void OnApplied();
+    void OnUpdate(float deltaTime);
+    void OnRemoved();
+    void OnSetArgs(const EffectArgs& args);
+
+    /* Measured time it took to render the last frame */
+    inline unsigned long GetFrameMicros() const { return m_FrameMicros; }
+private:
+    void Render();
+
+    static byte Noise(uint16_t x, uint16_t y, uint16_t z);
+private:
+    byte m_Speed;       // Lattice cells per second on the time axis, Q4.4
+    byte m_Scale;       // Lattice cells per LED, Q0.8
+    byte m_Brightness;
+    byte m_NumOctaves;
+
+    uint16_t m_Time;    // Q8.8, wraps with the lattice
+    float m_TimeRemainder;
+    float m_ElapsedTime;
+
+    unsigned long m_FrameMicros;
+};
+#endif // !NOISE_EFFECT_H
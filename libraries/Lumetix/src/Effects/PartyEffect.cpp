@@ -1,10 +1,11 @@
 #include "PartyEffect.h"
+#include "../Telemetry.h"
 
 /* Invokation helper for animation functions */
 #define INVOKE(func) ((this->*func)())
 
 PartyEffect::PartyEffect()
-    : EffectBase(EffectType::VIDEO_EFFECT)
+    : EffectBase(Type)
     , m_BpmDelay(.25f)
     , m_ElapsedTime(0)
     , m_SequenceIt(0)
@@ -43,15 +44,17 @@ void PartyEffect::OnUpdate(float deltaTime)
 
     if(m_ElapsedTime >= m_BpmDelay)
     {
-        Serial.println("Toggle Party Effect");
-
         // Toggle
         LedPanel& panel = gContext->Panel;
         
         // Perform animation step
-        m_RandomizeAnimations ? INVOKE(m_AnimationFunctions[GetRandomizedAnimation()]) :
-                                INVOKE(m_AnimationFunctions[m_AnimMode]);
-        //INVOKE(m_AnimationFunctions[m_AnimMode]);
+        const AnimationMode mode = (m_RandomizeAnimations ? GetRandomizedAnimation() : m_AnimMode);
+        INVOKE(m_AnimationFunctions[mode]);
+
+        if(Telemetry::IsDue(ETelemetryRecord::PARTY))
+        {
+            SendTelemetry(mode);
+        }
 
         // Reset timer 
         m_ElapsedTime = 0.f;
@@ -63,15 +66,17 @@ void PartyEffect::OnRemoved()
 
 }
 
-void PartyEffect::OnSetArgs(EffectArgs& args)
+/* (byte bpm) */
+typedef ArgSchema<Arg<byte, 1, 255>> ArgsSchema;
+
+void PartyEffect::OnSetArgs(const EffectArgs& args)
 {
     LOGN("Party Effect Arg");
-    // Expects update mode or bpm update
     LedPanel& panel = gContext->Panel;
 
-    if(args.NumArgs == 1)
+    byte bpm_byte;
+    if(ArgsSchema::Decode(args, bpm_byte))
     {
-        byte bpm_byte = args.ArgBuffer.GetByte();
         LOG("Arg: "); LOGN(bpm_byte);
         panel.TurnOn(true);
         panel.TurnOff(true);
@@ -87,8 +92,21 @@ void PartyEffect::SetAnimationMode(AnimationMode mode)
 
 void PartyEffect::SetBpmDelay(short bpmDelay_ms)
 {
-    Serial.print("newbpm: ");Serial.println(bpmDelay_ms);
     m_BpmDelay = (float)bpmDelay_ms/1000.f;
+
+    // A tempo change is worth reporting right away, not only with the next rate limited step
+    if(Telemetry::IsEnabled())
+    {
+        SendTelemetry(m_AnimMode);
+    }
+}
+
+void PartyEffect::SendTelemetry(AnimationMode mode) const
+{
+    TelemetryRecord(ETelemetryRecord::PARTY)
+        .PutU8(static_cast<uint8_t>(mode))
+        .PutU16((uint16_t)(m_BpmDelay * 1000.f + 0.5f))
+        .Send();
 }
 
 float PartyEffect::GetRandomizedBPM() const
@@ -5,6 +5,8 @@
 class PartyEffect : public EffectBase
 {
 public:
+    static constexpr EffectType Type = EffectType::VIDEO_EFFECT;
+
     PartyEffect();
 
     enum AnimationMode : short
@@ -16,10 +18,10 @@ public:
         MAX_VAL = 4
     };
 
-    virtual void OnApplied() override;
-    virtual void OnUpdate(float deltaTime) override;
-    virtual void OnRemoved() override;
-    virtual void OnSetArgs(EffectArgs& args) override;
+    void OnApplied();
+    void OnUpdate(float deltaTime);
+    void OnRemoved();
+    void OnSetArgs(const EffectArgs& args);
 
     void SetBpmDelay(short bpmDelay_ms);
     short GetBpmDelay() const { return m_BpmDelay; }
@@ -43,6 +45,9 @@ protected:
 
     float GetRandomizedBPM() const;
     AnimationMode GetRandomizedAnimation() const;
+
+    /* Party record: animation of the last step and the current delay between steps */
+    void SendTelemetry(AnimationMode mode) const;
 private:
     //unsigned short m_BpmDelay;
     //unsigned short m_ElapsedTime;
@@ -0,0 +1,268 @@
+#include "FrameCodec.h"
+
+#include <string.h>
+
+#define RLE_SKIP_FLAG 0x80
+
+static const size_t KEYFRAME_PAYLOAD_SIZE = sizeof(uint16_t) + FRAME_CODEC_FRAME_SIZE;
+
+static void PutUint16(uint8_t* out, uint16_t value)
+{
+    out[0] = (uint8_t)(value & 0xFF);
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static bool ValidateSparse(const uint8_t* data, size_t numBytes)
+{
+    if(numBytes % 2 != 0)
+        return false;
+
+    for(size_t i = 0; i < numBytes; i += 2)
+    {
+        if(data[i] >= FRAME_CODEC_FRAME_SIZE)
+            return false;
+    }
+
+    return true;
+}
+
+static bool ValidateRle(const uint8_t* data, size_t numBytes)
+{
+    size_t led = 0;
+    size_t i = 0;
+
+    while(i < numBytes)
+    {
+        const uint8_t token = data[i++];
+        const size_t run = (token & ~RLE_SKIP_FLAG) + 1;
+
+        if(led + run > FRAME_CODEC_FRAME_SIZE)
+            return false;
+
+        if(!(token & RLE_SKIP_FLAG))
+        {
+            if(i + run > numBytes)
+                return false;
+
+            i += run;
+        }
+
+        led += run;
+    }
+
+    return true;
+}
+
+bool ApplyFrameDelta(EFrameEncoding encoding, const uint8_t* data, size_t numBytes, uint8_t* frame)
+{
+    switch(encoding)
+    {
+        case EFrameEncoding::SPARSE:
+        {
+            if(!ValidateSparse(data, numBytes))
+                return false;
+
+            for(size_t i = 0; i < numBytes; i += 2)
+            {
+                frame[data[i]] ^= data[i + 1];
+            }
+        }
+        return true;
+
+        case EFrameEncoding::RLE:
+        {
+            if(!ValidateRle(data, numBytes))
+                return false;
+
+            uint8_t* led = frame;
+            size_t i = 0;
+
+            while(i < numBytes)
+            {
+                const uint8_t token = data[i++];
+                const size_t run = (token & ~RLE_SKIP_FLAG) + 1;
+
+                if(!(token & RLE_SKIP_FLAG))
+                {
+                    for(size_t j = 0; j < run; j++)
+                    {
+                        led[j] ^= data[i++];
+                    }
+                }
+
+                led += run;
+            }
+        }
+        return true;
+
+        default:
+        return false;
+    }
+}
+
+static bool EncodeSparse(const uint8_t* reference, const uint8_t* frame, uint8_t* out, size_t outCapacity, size_t& outNumBytes)
+{
+    size_t size = 0;
+
+    for(size_t i = 0; i < FRAME_CODEC_FRAME_SIZE; i++)
+    {
+        const uint8_t diff = reference[i] ^ frame[i];
+        if(diff == 0)
+            continue;
+
+        if(size + 2 > outCapacity)
+            return false;
+
+        out[size++] = (uint8_t)i;
+        out[size++] = diff;
+    }
+
+    outNumBytes = size;
+    return true;
+}
+
+static bool EncodeRle(const uint8_t* reference, const uint8_t* frame, uint8_t* out, size_t outCapacity, size_t& outNumBytes)
+{
+    size_t size = 0;
+    size_t i = 0;
+
+    // Changes past the last token are implicit, trailing unchanged LEDs cost nothing
+    size_t end = FRAME_CODEC_FRAME_SIZE;
+    while(end > 0 && reference[end - 1] == frame[end - 1])
+    {
+        end--;
+    }
+
+    while(i < end)
+    {
+        size_t run = 0;
+
+        if(reference[i] == frame[i])
+        {
+            while(i + run < end && run < FRAME_RLE_MAX_RUN && reference[i + run] == frame[i + run])
+            {
+                run++;
+            }
+
+            if(size + 1 > outCapacity)
+                return false;
+
+            out[size++] = (uint8_t)(RLE_SKIP_FLAG | (run - 1));
+        }
+        else
+        {
+            // A single unchanged LED costs as much inside a literal as it would to skip it, so literals absorb it
+            while(i + run < end && run < FRAME_RLE_MAX_RUN
+                && (reference[i + run] != frame[i + run] || (i + run + 1 < end && reference[i + run + 1] != frame[i + run + 1])))
+            {
+                run++;
+            }
+
+            if(size + 1 + run > outCapacity)
+                return false;
+
+            out[size++] = (uint8_t)(run - 1);
+            for(size_t j = 0; j < run; j++)
+            {
+                out[size++] = reference[i + j] ^ frame[i + j];
+            }
+        }
+
+        i += run;
+    }
+
+    outNumBytes = size;
+    return true;
+}
+
+bool EncodeFrameDelta(EFrameEncoding encoding, const uint8_t* reference, const uint8_t* frame
+                        , uint8_t* out, size_t outCapacity, size_t& outNumBytes)
+{
+    switch(encoding)
+    {
+        case EFrameEncoding::SPARSE:    return EncodeSparse(reference, frame, out, outCapacity, outNumBytes);
+        case EFrameEncoding::RLE:       return EncodeRle(reference, frame, out, outCapacity, outNumBytes);
+        default:                        return false;
+    }
+}
+
+FrameEncoder::FrameEncoder(uint16_t keyframeInterval)
+    : m_KeyframeInterval(keyframeInterval)
+{
+    Reset();
+}
+
+void FrameEncoder::Reset()
+{
+    memset(m_Reference, 0, sizeof(m_Reference));
+    m_Sequence = 0;
+    m_FramesSinceKeyframe = 0;
+    m_bNeedsKeyframe = true;
+}
+
+void FrameEncoder::RequestKeyframe()
+{
+    m_bNeedsKeyframe = true;
+}
+
+size_t FrameEncoder::Encode(const uint8_t* frame, EProtocolCommand& outCommand, uint8_t* out, size_t outCapacity)
+{
+    if(outCapacity < PROTOCOL_MAX_PAYLOAD)
+        return 0;
+
+    size_t size = 0;
+
+    if(!m_bNeedsKeyframe && m_FramesSinceKeyframe < m_KeyframeInterval)
+    {
+        // A delta is only worth sending if it is smaller than the keyframe
+        uint8_t* data = out + FRAME_DELTA_HEADER_SIZE;
+        const size_t dataCapacity = KEYFRAME_PAYLOAD_SIZE - FRAME_DELTA_HEADER_SIZE - 1;
+
+        size_t sparseSize = 0;
+        size_t rleSize = 0;
+        const bool bSparse = EncodeFrameDelta(EFrameEncoding::SPARSE, m_Reference, frame, data, dataCapacity, sparseSize);
+
+        // RLE overwrites the sparse encoding only if it beats it
+        const size_t rleCapacity = (bSparse ? (sparseSize > 0 ? sparseSize - 1 : 0) : dataCapacity);
+        const bool bRle = EncodeFrameDelta(EFrameEncoding::RLE, m_Reference, frame, data, rleCapacity, rleSize);
+
+        if(bRle || bSparse)
+        {
+            EFrameEncoding encoding = EFrameEncoding::RLE;
+            size = rleSize;
+
+            if(!bRle)
+            {
+                encoding = EFrameEncoding::SPARSE;
+                EncodeFrameDelta(encoding, m_Reference, frame, data, dataCapacity, size);
+            }
+
+            PutUint16(&out[0], m_Sequence);
+            PutUint16(&out[2], (uint16_t)(m_Sequence - 1));
+            out[4] = static_cast<uint8_t>(encoding);
+
+            size += FRAME_DELTA_HEADER_SIZE;
+            outCommand = EProtocolCommand::STREAM_DELTA;
+            m_FramesSinceKeyframe++;
+        }
+    }
+
+    if(size == 0)
+    {
+        size = EncodeKeyframe(frame, out);
+        outCommand = EProtocolCommand::STREAM_FRAME;
+        m_FramesSinceKeyframe = 0;
+        m_bNeedsKeyframe = false;
+    }
+
+    memcpy(m_Reference, frame, sizeof(m_Reference));
+    m_Sequence++;
+    return size;
+}
+
+size_t FrameEncoder::EncodeKeyframe(const uint8_t* frame, uint8_t* out)
+{
+    PutUint16(&out[0], m_Sequence);
+    memcpy(&out[2], frame, FRAME_CODEC_FRAME_SIZE);
+    return KEYFRAME_PAYLOAD_SIZE;
+}
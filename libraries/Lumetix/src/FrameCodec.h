@@ -0,0 +1,73 @@
+#ifndef FRAME_CODEC_H
+#define FRAME_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ProtocolFraming.h"
+
+/* Bytes in a streamed frame, one per LED laid out as a PanelFrame */
+#define FRAME_CODEC_FRAME_SIZE 64
+
+/* STREAM_DELTA header: uint16 sequence, uint16 baseSequence, byte encoding */
+#define FRAME_DELTA_HEADER_SIZE 5
+
+/* Longest run a single RLE token can describe */
+#define FRAME_RLE_MAX_RUN 128
+
+/*  Frame Delta Encodings
+*
+*   A delta is the XOR of a frame against the reference frame, so unchanged LEDs are zeros.
+*
+*   SPARSE lists the changed LEDs as (byte index, byte xor) pairs, best for a handful of scattered changes.
+*   RLE is a list of tokens over the whole XOR: [0x80 | (n - 1)] skips n unchanged LEDs, [n - 1] is followed
+*   by n literal XOR bytes. Best for contiguous changes, i.e a whole panel fading.
+*/
+enum class EFrameEncoding : uint8_t
+{
+    SPARSE  = 0,
+    RLE     = 1,
+    MAX_VAL
+};
+
+/*  Applies a delta to frame, in place. The delta is validated in full before frame is touched,
+*   a malformed delta returns false and leaves frame as it was.
+*/
+bool ApplyFrameDelta(EFrameEncoding encoding, const uint8_t* data, size_t numBytes, uint8_t* frame);
+
+/*  Encodes the delta from reference to frame. Returns false if out can not hold it,
+*   which is how the caller learns an encoding would not beat a keyframe.
+*/
+bool EncodeFrameDelta(EFrameEncoding encoding, const uint8_t* reference, const uint8_t* frame
+                        , uint8_t* out, size_t outCapacity, size_t& outNumBytes);
+
+/*  Frame Encoder
+*
+*   Sending end of a frame stream, for the host tools. Every frame is sent as the smallest of a keyframe
+*   (STREAM_FRAME) and a delta against the last frame sent (STREAM_DELTA). Deltas are only ever applied
+*   on top of the exact frame they were encoded against, so if the device misses a packet it rejects
+*   the following deltas and replies STREAM_RESYNC, call RequestKeyframe then.
+*   Keyframes are also forced every keyframeInterval frames, which bounds recovery if the request is lost too.
+*/
+class FrameEncoder
+{
+public:
+    FrameEncoder(uint16_t keyframeInterval = 30);
+
+    /* Builds the packet payload for the next frame. Returns its size, or 0 if out can not hold PROTOCOL_MAX_PAYLOAD bytes */
+    size_t Encode(const uint8_t* frame, EProtocolCommand& outCommand, uint8_t* out, size_t outCapacity);
+
+    void RequestKeyframe();
+    void Reset();
+
+    inline uint16_t GetSequence() const { return m_Sequence; }
+private:
+    size_t EncodeKeyframe(const uint8_t* frame, uint8_t* out);
+private:
+    uint8_t m_Reference[FRAME_CODEC_FRAME_SIZE];
+    uint16_t m_Sequence;        // Of the next frame
+    uint16_t m_KeyframeInterval;
+    uint16_t m_FramesSinceKeyframe;
+    bool m_bNeedsKeyframe;
+};
+#endif // !FRAME_CODEC_H
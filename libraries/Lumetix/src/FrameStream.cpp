@@ -0,0 +1,142 @@
+#include "FrameStream.h"
+
+#include "Common.h"
+
+static_assert(FRAME_CODEC_FRAME_SIZE == NUM_LEDS, "Streamed frames must cover the whole panel");
+
+FrameStream::FrameStream(LedPanel& panel)
+    : m_Panel(panel)
+    , m_bPending(false)
+    , m_bActive(false)
+    , m_bHasReference(false)
+    , m_LastSequence(0)
+    , m_bHasSequence(false)
+    , m_WindowStart(0)
+    , m_WindowFrames(0)
+{
+    memset(&m_Stats, 0, sizeof(m_Stats));
+}
+
+void FrameStream::Start()
+{
+    m_bActive = true;
+    m_bPending = false;
+    m_bHasReference = false;
+    m_bHasSequence = false;
+
+    memset(&m_Stats, 0, sizeof(m_Stats));
+    m_WindowStart = millis();
+    m_WindowFrames = 0;
+
+    LOGN("Stream started");
+}
+
+void FrameStream::Stop()
+{
+    m_bActive = false;
+    m_bPending = false;
+    m_bHasReference = false;
+
+    LOGN("Stream stopped");
+}
+
+void FrameStream::Receive(const byte* frame)
+{
+    m_Stats.NumReceived++;
+
+    // Without a sequence number, later deltas have nothing to name as their base
+    m_bHasSequence = false;
+
+    memcpy(m_Panel.EditTargets(), frame, NUM_LEDS);
+    m_bHasReference = true;
+    MarkPending();
+}
+
+void FrameStream::Receive(const byte* frame, uint16_t sequence)
+{
+    m_Stats.NumReceived++;
+
+    // Never stale: a keyframe does not depend on what came before, it restarts the sequence from its own
+    Accept(sequence);
+
+    memcpy(m_Panel.EditTargets(), frame, NUM_LEDS);
+    m_bHasReference = true;
+    MarkPending();
+}
+
+EDeltaResult FrameStream::ReceiveDelta(uint16_t sequence, uint16_t baseSequence, EFrameEncoding encoding, const byte* data, size_t numBytes)
+{
+    m_Stats.NumReceived++;
+
+    if(IsStale(sequence))
+    {
+        m_Stats.NumStale++;
+        return EDeltaResult::STALE;
+    }
+
+    // A packet was lost in between, applying this delta would corrupt the frame until the next keyframe
+    if(!m_bHasReference || !m_bHasSequence || baseSequence != m_LastSequence)
+    {
+        m_Stats.NumRejected++;
+        return EDeltaResult::MISSING_BASE;
+    }
+
+    // Decoded in place, the targets still hold the base frame
+    if(!ApplyFrameDelta(encoding, data, numBytes, m_Panel.EditTargets()))
+    {
+        m_Stats.NumRejected++;
+        return EDeltaResult::MALFORMED;
+    }
+
+    Accept(sequence);
+    MarkPending();
+    return EDeltaResult::APPLIED;
+}
+
+bool FrameStream::IsStale(uint16_t sequence) const
+{
+    // Anything not ahead of the last accepted frame arrived late, showing it would step back in time
+    return m_bHasSequence && (int16_t)(sequence - m_LastSequence) <= 0;
+}
+
+void FrameStream::Accept(uint16_t sequence)
+{
+    m_LastSequence = sequence;
+    m_bHasSequence = true;
+}
+
+void FrameStream::MarkPending()
+{
+    // The bus fell behind, the previous frame is superseded before it was ever shown
+    if(m_bPending)
+    {
+        m_Stats.NumDropped++;
+    }
+
+    m_bPending = true;
+}
+
+void FrameStream::Update()
+{
+    if(!m_bActive)
+        return;
+
+    if(m_bPending)
+    {
+        m_Panel.Snap();
+        m_bPending = false;
+
+        m_Stats.NumCommitted++;
+        m_WindowFrames++;
+    }
+
+    const unsigned long now = millis();
+    const unsigned long elapsed = now - m_WindowStart;
+
+    if(elapsed >= FRAME_STREAM_FPS_WINDOW)
+    {
+        m_Stats.FpsX10 = (uint16_t)((m_WindowFrames * 10000UL) / elapsed);
+        m_WindowStart = now;
+        m_WindowFrames = 0;
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef FRAME_STREAM_H
+#define FRAME_STREAM_H
+
+#include <Arduino.h>
+
+#include "LedPanel.h"
+#include "FrameCodec.h"
+
+/* Window over which the achieved frame rate is measured, in ms */
+#define FRAME_STREAM_FPS_WINDOW 1000
+
+struct FrameStreamStats
+{
+    uint16_t FpsX10;        // Frames committed per second over the last complete window, times 10
+    uint16_t NumReceived;
+    uint16_t NumCommitted;
+    uint16_t NumStale;      // Deltas with out of order or duplicate sequence numbers
+    uint16_t NumDropped;    // Superseded by a newer frame before the panel could show them
+    uint16_t NumRejected;   // Deltas that were malformed or whose base frame was missed
+};
+
+enum class EDeltaResult : uint8_t
+{
+    APPLIED,
+    STALE,
+    MISSING_BASE,   // A keyframe is needed before any further delta can apply
+    MALFORMED
+};
+
+/*  Frame Stream
+*
+*   Host-driven video: the host renders every frame and streams it, the firmware only displays it.
+*   Frames are decoded straight into the panel targets, which also serve as the reference for the next delta,
+*   and committed to the hardware once per loop. The panel therefore always shows the newest frame: if frames
+*   arrive faster than the bus can write them, older ones are overwritten instead of queuing up latency.
+*
+*   Keyframes carry a full frame, deltas are XORed on top of the previous frame (see FrameCodec.h). A delta only
+*   applies on top of the exact frame it was encoded against, identified by its base sequence number.
+*
+*   Frames may carry a 16 bit sequence number, deltas older than the last accepted frame are discarded as stale.
+*   Sequences wrap around, a frame is considered newer if it is less than half the sequence range ahead.
+*   Keyframes are self-contained and always accepted, they re-anchor the sequence. A new host session (i.e one
+*   restarting its sequence at 0) resynchronizes with its first keyframe, whatever the previous session sent.
+*
+*   Nothing else may write the panel targets while streaming, the protocol handler clears all effects on start.
+*/
+class FrameStream
+{
+public:
+    FrameStream(LedPanel& panel);
+
+    void Start();
+    void Stop();
+    inline bool IsActive() const { return m_bActive; }
+
+    /* Keyframes of NUM_LEDS bytes, laid out as a PanelFrame */
+    void Receive(const byte* frame);
+    void Receive(const byte* frame, uint16_t sequence);
+
+    EDeltaResult ReceiveDelta(uint16_t sequence, uint16_t baseSequence, EFrameEncoding encoding, const byte* data, size_t numBytes);
+
+    /* Commits the pending frame, if any. Call once per loop */
+    void Update();
+
+    inline const FrameStreamStats& GetStats() const { return m_Stats; }
+private:
+    bool IsStale(uint16_t sequence) const;
+    void Accept(uint16_t sequence);
+    void MarkPending();
+private:
+    LedPanel& m_Panel;
+
+    bool m_bPending;
+    bool m_bActive;
+
+    /* Panel targets hold a complete frame that deltas can apply to */
+    bool m_bHasReference;
+
+    uint16_t m_LastSequence;
+    bool m_bHasSequence;
+
+    unsigned long m_WindowStart;
+    uint16_t m_WindowFrames;
+
+    FrameStreamStats m_Stats;
+};
+#endif // !FRAME_STREAM_H
@@ -1,6 +1,7 @@
 #include "LedPanel.h"
 
 #include "HardwareSerial.h"
+#include "Profiler.h"
 
 #define CLAMP(val, min, max) (val < min ? min : val > max ? max : val)
 
@@ -11,9 +12,13 @@ ELedColor LedPanel::m_ColorMap[] =
 };
 
 LedPanel::LedPanel(TLC59116Manager& tlcmanager)
-    : m_TransitionSpeed(1.f)
+    : bInterpolates(true)
+    , m_Target(m_LedBuffer)
+    , m_bTargetWritten(false)
+    , m_bSnapPending(false)
+    , m_TransitionSpeed(1.f)
     , m_TlcManager(tlcmanager)
-    , bInterpolates(true)
+    , m_WriteCallback(nullptr)
 {
     /* Zero out the buffers */
     for(int panel = 0; panel < EPanel::MAX_VAL; panel++)
@@ -38,6 +43,7 @@ void LedPanel::Init()
 
 void LedPanel::Update(float deltaTime)
 {
+    PROFILE_SUBSYSTEM_SCOPE(EProfileSubsystem::PANEL_UPDATE);
     UpdateLedBuffer(deltaTime);
 }
 
@@ -54,14 +60,16 @@ void LedPanel::SetBrightness(ELedColor color, byte brightness, EUpdateMode updat
         {
             if(m_ColorMap[i] == color)
             {
-                m_LedBuffer[panel][i] = brightness;
+                m_Target[panel][i] = brightness;
             }
             else if(updateMode == EUpdateMode::ZERO_UNSELECTED)
             {
-                m_LedBuffer[panel][i] = 0;
+                m_Target[panel][i] = 0;
             }
         }
     }
+
+    m_bTargetWritten = true;
 }
 
 void LedPanel::SetBrightness(EPanel panel, ELedColor color, byte brightness, EUpdateMode updateMode)
@@ -70,25 +78,29 @@ void LedPanel::SetBrightness(EPanel panel, ELedColor color, byte brightness, EUp
     {
         if(m_ColorMap[i] == color)
         {
-            m_LedBuffer[panel][i] = brightness;
+            m_Target[panel][i] = brightness;
         }
         else if(updateMode == EUpdateMode::ZERO_UNSELECTED)
         {
-            //m_LedBuffer[panel][i] = brightness;
-            m_LedBuffer[panel][i] = 0;
+            //m_Target[panel][i] = brightness;
+            m_Target[panel][i] = 0;
         }
     }
+
+    m_bTargetWritten = true;
 }
 
 void LedPanel::SetBrightness(EPanel panel, byte brightness, EUpdateMode updateMode)
 {
     for(int i = 0; i < NUM_CHANNELS; i++)
     {
-        byte currBrightness = m_LedBuffer[panel][i];
+        byte currBrightness = m_Target[panel][i];
         byte newBrightness = BlendBrightness(currBrightness, brightness, updateMode);
 
-        m_LedBuffer[panel][i] = newBrightness;
+        m_Target[panel][i] = newBrightness;
     }
+
+    m_bTargetWritten = true;
 }
 
 void LedPanel::SetBrightness(byte brightness, EUpdateMode updateMode)
@@ -97,12 +109,14 @@ void LedPanel::SetBrightness(byte brightness, EUpdateMode updateMode)
     {
         for(int i = 0; i < NUM_CHANNELS; i++)
         {
-            byte currBrightness = m_LedBuffer[panel][i];
+            byte currBrightness = m_Target[panel][i];
             byte newBrightness = BlendBrightness(currBrightness, brightness, updateMode);
 
-            m_LedBuffer[panel][i] = newBrightness;
+            m_Target[panel][i] = newBrightness;
         }
     }
+
+    m_bTargetWritten = true;
 }
 
 void LedPanel::FromChannelMap(unsigned short top, unsigned short right, unsigned short bottom, unsigned short left, byte brightness, EUpdateMode updateMode)
@@ -116,25 +130,21 @@ void LedPanel::FromChannelMap(unsigned short top, unsigned short right, unsigned
         byte leftBrightness     = (((1 << channel) & left) == 0)      ? 0 : brightness;
 
         // Perform update mode blending based on previous and new target values
-        topBrightness       = BlendBrightness(m_LedBuffer[0][channel], topBrightness, updateMode);
-        rightBrightness     = BlendBrightness(m_LedBuffer[1][channel], rightBrightness, updateMode);
-        bottomBrightness    = BlendBrightness(m_LedBuffer[2][channel], bottomBrightness, updateMode);
-        leftBrightness      = BlendBrightness(m_LedBuffer[3][channel], leftBrightness, updateMode);
+        topBrightness       = BlendBrightness(m_Target[0][channel], topBrightness, updateMode);
+        rightBrightness     = BlendBrightness(m_Target[1][channel], rightBrightness, updateMode);
+        bottomBrightness    = BlendBrightness(m_Target[2][channel], bottomBrightness, updateMode);
+        leftBrightness      = BlendBrightness(m_Target[3][channel], leftBrightness, updateMode);
 
-        // Update both the current and target buffer for immediate change
-        m_LedBuffer[0][channel] = topBrightness;
-        m_LedBuffer[1][channel] = rightBrightness;
-        m_LedBuffer[2][channel] = bottomBrightness;
-        m_LedBuffer[3][channel] = leftBrightness;
-
-        // @TODO: This can be removed. UpdateLedBuffer will perform this if deltaTime >= (1/transitionSpeed).
-        m_CurrLedBuffer[0][channel] = topBrightness;
-        m_CurrLedBuffer[1][channel] = rightBrightness;
-        m_CurrLedBuffer[2][channel] = bottomBrightness;
-        m_CurrLedBuffer[3][channel] = leftBrightness;
+        m_Target[0][channel] = topBrightness;
+        m_Target[1][channel] = rightBrightness;
+        m_Target[2][channel] = bottomBrightness;
+        m_Target[3][channel] = leftBrightness;
     }
 
-    UpdateLedBuffer(1);
+    m_bTargetWritten = true;
+
+    // Every channel was written, so update the current buffer as well for an immediate change
+    Snap();
 }
 
 void LedPanel::SetChannelBrightness(EPanel panel, byte brightness, int* channels, size_t count)
@@ -147,11 +157,30 @@ void LedPanel::SetChannelBrightness(EPanel panel, byte brightness, int* channels
     for(int i = 0; i < count; i++)
     {
         const int channel = channels[i];
-        m_LedBuffer[panelId][channel] = brightness;
-        m_CurrLedBuffer[panelId][channel] = brightness;
+        m_Target[panelId][channel] = brightness;
+
+        if(!IsLayerBound())
+        {
+            m_CurrLedBuffer[panelId][channel] = brightness;
+        }
     }
 
-    UpdateLedBuffer(1);
+    m_bTargetWritten = true;
+
+    if(IsLayerBound())
+    {
+        m_bSnapPending = true;
+    }
+    else
+    {
+        UpdateLedBuffer(1);
+    }
+}
+
+byte* LedPanel::EditTargets()
+{
+    m_bTargetWritten = true;
+    return &m_Target[0][0];
 }
 
 byte LedPanel::BlendBrightness(byte prevVal, byte newVal, EUpdateMode updateMode) const
@@ -191,8 +220,15 @@ void LedPanel::UpdateLedBuffer(float deltaTime)
             }
 
             m_CurrLedBuffer[panel][i] = newIntensity;
-            m_TlcManager[panel].pwm(i, newIntensity);
         }
+
+        if(m_WriteCallback)
+        {
+            m_WriteCallback();
+        }
+
+        // One bulk write per driver, which only transmits the registers that changed
+        m_TlcManager[panel].pwm(m_CurrLedBuffer[panel]);
     }
 }
 
@@ -202,15 +238,16 @@ void LedPanel::TurnOff(bool bImmediate)
     {
         for(int i = 0; i < NUM_CHANNELS; i++)
         {
-            m_LedBuffer[panel][i] = 0;
-            
-            if(bImmediate)
-            {
-                m_CurrLedBuffer[panel][i] = 0;
-                m_TlcManager[panel].pwm(i, 0);
-            }
+            m_Target[panel][i] = 0;
         }
     }
+
+    m_bTargetWritten = true;
+
+    if(bImmediate)
+    {
+        Snap();
+    }
 }
 
 void LedPanel::TurnOn(bool bImmediate)
@@ -219,13 +256,79 @@ void LedPanel::TurnOn(bool bImmediate)
     {
         for(int i = 0; i < NUM_CHANNELS; i++)
         {
-            m_LedBuffer[panel][i] = 255;
+            m_Target[panel][i] = 255;
+        }
+    }
 
-            if(bImmediate)
-            {
-                m_CurrLedBuffer[panel][i] = 255;
-                m_TlcManager[panel].pwm(i, 255);
-            }
+    m_bTargetWritten = true;
+
+    if(bImmediate)
+    {
+        Snap();
+    }
+}
+
+void LedPanel::Snap()
+{
+    if(IsLayerBound())
+    {
+        m_bSnapPending = true;
+        return;
+    }
+
+    memcpy(m_CurrLedBuffer, m_LedBuffer, sizeof(m_LedBuffer));
+    UpdateLedBuffer(1);
+}
+
+void LedPanel::BeginLayer(PanelFrame& frame)
+{
+    m_Target = frame;
+    m_bTargetWritten = false;
+}
+
+bool LedPanel::EndLayer()
+{
+    const bool bWritten = m_bTargetWritten;
+
+    m_Target = m_LedBuffer;
+    m_bTargetWritten = false;
+    return bWritten;
+}
+
+void LedPanel::BeginComposite()
+{
+    memset(m_LedBuffer, 0, sizeof(m_LedBuffer));
+}
+
+void LedPanel::CompositeLayer(const PanelFrame& frame, EUpdateMode blendMode)
+{
+    for(int panel = 0; panel < EPanel::MAX_VAL; panel++)
+    {
+        for(int i = 0; i < NUM_CHANNELS; i++)
+        {
+            m_LedBuffer[panel][i] = BlendBrightness(m_LedBuffer[panel][i], frame[panel][i], blendMode);
         }
     }
-}
\ No newline at end of file
+}
+
+void LedPanel::CrossfadeLayer(const PanelFrame& frame, uint16_t alpha)
+{
+    const uint16_t invAlpha = 256 - alpha;
+
+    for(int panel = 0; panel < EPanel::MAX_VAL; panel++)
+    {
+        for(int i = 0; i < NUM_CHANNELS; i++)
+        {
+            m_LedBuffer[panel][i] = (m_LedBuffer[panel][i] * invAlpha + frame[panel][i] * alpha) >> 8;
+        }
+    }
+}
+
+void LedPanel::EndComposite()
+{
+    if(m_bSnapPending)
+    {
+        m_bSnapPending = false;
+        Snap();
+    }
+}
@@ -18,6 +18,10 @@ enum EPanel : uint8_t
     MAX_VAL = 4
 };
 
+/* A full panel worth of LED intensities, indexed by panel then channel */
+typedef byte PanelFrame[EPanel::MAX_VAL][NUM_CHANNELS];
+#define NUM_LEDS (EPanel::MAX_VAL * NUM_CHANNELS)
+
 enum ELedColor : uint8_t
 {
     WHITE   = (1 << 1),
@@ -87,13 +91,53 @@ public:
     */
     void SetChannelBrightness(EPanel panel, byte brightness, int* channels, size_t count);
 
+    /*  Direct access to the brightness targets for bulk writers such as decoders. Targets are laid out
+    *   panel by panel, where the LED index is (panel * NUM_CHANNELS + channel). The target is considered written.
+    */
+    byte* EditTargets();
+
     void TurnOff(bool bImmediate = false);
     void TurnOn(bool bImmediate = false);
 
+    /*  Immediately moves the panel to its target values, or defers it to EndComposite if a layer is bound.
+    *   Costs one bulk write per driver.
+    */
+    void Snap();
+
+    /*  Called before each driver's bulk write. A whole panel write keeps the bus busy for longer than the UART
+    *   can buffer input at high baud rates, the sketch drains serial input here in between.
+    */
+    typedef void (*WriteCallback)();
+    inline void SetWriteCallback(WriteCallback callback) { m_WriteCallback = callback; }
+
+    /*  Layers
+    *
+    *   While a layer is bound, all of the above setters write into the layer's frame instead of the panel.
+    *   Immediate requests do not reach the hardware, they instead snap the panel on the next composite.
+    *   This lets several effects render independently and be composited into a single panel frame.
+    *
+    *   EndLayer returns true if the layer was written to since it was bound.
+    */
+    void BeginLayer(PanelFrame& frame);
+    bool EndLayer();
+
+    /*  Compositing
+    *
+    *   BeginComposite clears the panel targets, each CompositeLayer then blends a frame on top
+    *   of the result using the given update mode. EndComposite applies any pending snap requested by the layers.
+    */
+    void BeginComposite();
+    void CompositeLayer(const PanelFrame& frame, EUpdateMode blendMode);
+    void EndComposite();
+
+    /* Fades the composited result towards the given frame, where alpha is fixed point in [0, 256] */
+    void CrossfadeLayer(const PanelFrame& frame, uint16_t alpha);
+
     bool bInterpolates;
 private:
     byte BlendBrightness(byte prevVal, byte newVal, EUpdateMode updateMode) const;
     void UpdateLedBuffer(float deltaTime);
+    inline bool IsLayerBound() const { return m_Target != m_LedBuffer; }
 private:
     static ELedColor m_ColorMap[NUM_CHANNELS];
 
@@ -103,8 +147,14 @@ private:
     byte m_LedBuffer[EPanel::MAX_VAL][NUM_CHANNELS];
     byte m_CurrLedBuffer[EPanel::MAX_VAL][NUM_CHANNELS];
 
+    /* Buffer written by the setters. Either m_LedBuffer, or the frame of the bound layer */
+    byte (*m_Target)[NUM_CHANNELS];
+    bool m_bTargetWritten;
+    bool m_bSnapPending;
+
     float m_TransitionSpeed;
 
     TLC59116Manager& m_TlcManager;
+    WriteCallback m_WriteCallback;
 };
 #endif
\ No newline at end of file
@@ -4,8 +4,18 @@
 #include <Common.h>
 #include <Context.h>
 #include <LedPanel.h>
+#include <RgbSampler.h>
+#include <SignalConditioner.h>
+#include <PIController.h>
 #include <EffectRegistry.h>
 #include <EffectBase.h>
+#include <EffectArgs.h>
+#include <ByteRing.h>
+#include <ProtocolHandler.h>
+#include <FrameStream.h>
+#include <EffectList.h>
 #include <LightSequencer.h>
+#include <Profiler.h>
+#include <Telemetry.h>
 
 #endif
@@ -0,0 +1,45 @@
+#include "PIController.h"
+
+PIController::PIController(int16_t kp, int16_t ki, int16_t outMin, int16_t outMax, int16_t maxStep)
+    : Kp(kp)
+    , Ki(ki)
+    , OutMin(outMin)
+    , OutMax(outMax)
+    , MaxStep(maxStep)
+    , m_Integral(0)
+    , m_Output(0)
+{
+}
+
+int16_t PIController::Step(int16_t error)
+{
+    const int32_t proportional = (int32_t)Kp * error;
+    const int32_t integral = m_Integral + (int32_t)Ki * error;
+
+    int32_t output = (proportional + integral) >> 8;
+
+    // Limits. Output first, then the step from the previous output.
+    bool bSaturated = false;
+    if(output > OutMax)         { output = OutMax; bSaturated = (error > 0); }
+    else if(output < OutMin)    { output = OutMin; bSaturated = (error < 0); }
+
+    if(output > m_Output + MaxStep)         { output = m_Output + MaxStep; bSaturated |= (error > 0); }
+    else if(output < m_Output - MaxStep)    { output = m_Output - MaxStep; bSaturated |= (error < 0); }
+
+    // Only integrate when it can actually affect the output
+    if(!bSaturated)
+    {
+        const int32_t integralMax = (int32_t)OutMax << 8;
+        const int32_t integralMin = (int32_t)OutMin << 8;
+        m_Integral = integral > integralMax ? integralMax : integral < integralMin ? integralMin : integral;
+    }
+
+    m_Output = output;
+    return m_Output;
+}
+
+void PIController::Reset(int16_t output)
+{
+    m_Output = output;
+    m_Integral = (int32_t)output << 8;
+}
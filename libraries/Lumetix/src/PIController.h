@@ -0,0 +1,35 @@
+#ifndef PI_CONTROLLER_H
+#define PI_CONTROLLER_H
+
+#include <Arduino.h>
+
+/*  Fixed-point PI controller
+*
+*   Gains are Q8.8, errors and outputs are plain integers in whatever units the caller picks.
+*   The output is clamped to [OutMin, OutMax] and may not move by more than MaxStep per step.
+*
+*   Anti-windup: the integral is clamped such that it alone can't push the output past its limits,
+*   and it stops accumulating while the output is saturated (or rate limited) in the direction of the error.
+*/
+struct PIController
+{
+    PIController(int16_t kp, int16_t ki, int16_t outMin, int16_t outMax, int16_t maxStep);
+
+    /* Advances the controller by one sample and returns the new output */
+    int16_t Step(int16_t error);
+
+    /* Bumpless reset to the given output */
+    void Reset(int16_t output);
+
+    inline int16_t GetOutput() const { return m_Output; }
+
+    int16_t Kp; // Q8.8
+    int16_t Ki; // Q8.8
+    int16_t OutMin;
+    int16_t OutMax;
+    int16_t MaxStep;
+private:
+    int32_t m_Integral; // Q8.8, output units
+    int16_t m_Output;
+};
+#endif // !PI_CONTROLLER_H
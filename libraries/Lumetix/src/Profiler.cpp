@@ -0,0 +1,122 @@
+#include "Profiler.h"
+
+#ifdef PROFILE_MODE
+
+#include "EffectRegistry.h"
+
+static ProfileStats s_SubsystemStats[static_cast<int>(EProfileSubsystem::MAX_VAL)];
+static ProfileStats s_EffectStats[NUM_EFFECTS];
+
+static const char* const s_SubsystemNames[] =
+{
+    "Sampler",
+    "Panel",
+    "Composite"
+};
+
+void Profiler::RecordEffect(unsigned int effectId, unsigned long duration)
+{
+    if(effectId < NUM_EFFECTS)
+    {
+        Record(s_EffectStats[effectId], duration);
+    }
+}
+
+void Profiler::RecordSubsystem(EProfileSubsystem subsystem, unsigned long duration)
+{
+    Record(s_SubsystemStats[static_cast<int>(subsystem)], duration);
+}
+
+const ProfileStats* Profiler::GetEffectStats(unsigned int effectId)
+{
+    return (effectId < NUM_EFFECTS ? &s_EffectStats[effectId] : nullptr);
+}
+
+const ProfileStats& Profiler::GetSubsystemStats(EProfileSubsystem subsystem)
+{
+    return s_SubsystemStats[static_cast<int>(subsystem)];
+}
+
+void Profiler::Record(ProfileStats& stats, unsigned long duration)
+{
+    if(stats.Count == 0 || duration < stats.Min)
+    {
+        stats.Min = duration;
+    }
+
+    if(duration > stats.Max)
+    {
+        stats.Max = duration;
+    }
+
+    // Halving both keeps the average while making room for more samples
+    if(stats.Count == 0xFFFF || stats.Total > 0xFFFFFFFFUL - duration)
+    {
+        stats.Count >>= 1;
+        stats.Total >>= 1;
+    }
+
+    stats.Count++;
+    stats.Total += duration;
+
+    byte bin = 0;
+    for(unsigned long scaled = duration >> PROFILE_HISTOGRAM_SHIFT; scaled > 1 && bin < PROFILE_HISTOGRAM_BINS - 1; scaled >>= 1)
+    {
+        bin++;
+    }
+
+    // Halving all bins keeps the shape of the distribution
+    if(stats.Histogram[bin] == 0xFFFF)
+    {
+        for(int i = 0; i < PROFILE_HISTOGRAM_BINS; i++)
+        {
+            stats.Histogram[i] >>= 1;
+        }
+    }
+
+    stats.Histogram[bin]++;
+}
+
+void Profiler::Report(Print& out)
+{
+    for(int i = 0; i < static_cast<int>(EProfileSubsystem::MAX_VAL); i++)
+    {
+        out.print(s_SubsystemNames[i]);
+        ReportEntry(out, s_SubsystemStats[i]);
+    }
+
+    for(unsigned int i = 0; i < NUM_EFFECTS; i++)
+    {
+        // Photo effects and effects that never ran have nothing to report
+        if(s_EffectStats[i].Count == 0)
+            continue;
+
+        out.print("Effect "); out.print(i);
+        ReportEntry(out, s_EffectStats[i]);
+    }
+}
+
+void Profiler::ReportEntry(Print& out, const ProfileStats& stats)
+{
+    const unsigned long average = (stats.Count > 0 ? stats.Total / stats.Count : 0);
+
+    out.print(' '); out.print(stats.Count);
+    out.print(' '); out.print(stats.Min);
+    out.print(' '); out.print(average);
+    out.print(' '); out.print(stats.Max);
+    out.print(" |");
+
+    for(int i = 0; i < PROFILE_HISTOGRAM_BINS; i++)
+    {
+        out.print(' '); out.print(stats.Histogram[i]);
+    }
+    out.println();
+}
+
+void Profiler::Reset()
+{
+    memset(s_SubsystemStats, 0, sizeof(s_SubsystemStats));
+    memset(s_EffectStats, 0, sizeof(s_EffectStats));
+}
+
+#endif // PROFILE_MODE
@@ -0,0 +1,104 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <Arduino.h>
+
+/* Uncomment to profile effects and subsystems. When commented out, every PROFILE_ macro compiles to nothing */
+//#define PROFILE_MODE
+
+/* Histogram bin i counts durations within [2^(i + shift), 2^(i + shift + 1)) us. First and last bins are open ended */
+#define PROFILE_HISTOGRAM_BINS 10
+#define PROFILE_HISTOGRAM_SHIFT 5
+
+enum class EProfileSubsystem : uint8_t
+{
+    SAMPLER_UPDATE,
+    PANEL_UPDATE,
+    COMPOSITE,
+    MAX_VAL
+};
+
+/* Kind of entry in a PROFILE_REPORT packet, the entry's id is an EProfileSubsystem or an effect id */
+enum class EProfileEntry : uint8_t
+{
+    SUBSYSTEM,
+    EFFECT
+};
+
+struct ProfileStats
+{
+    unsigned long Min;      // us
+    unsigned long Max;      // us
+    unsigned long Total;    // us, over Count samples
+    uint16_t Count;
+    uint16_t Histogram[PROFILE_HISTOGRAM_BINS];
+};
+
+/*  Profiler
+*
+*   Accumulates micros() timings of each effect's update and of the main subsystems. Each entry keeps
+*   min/avg/max and a log2 histogram, which is enough to budget the main loop without a logic analyzer.
+*   Counters are halved when they would saturate, so long runs keep a meaningful average and distribution.
+*
+*   Instrument code with PROFILE_EFFECT_SCOPE/PROFILE_SUBSYSTEM_SCOPE, which time the rest of the enclosing block.
+*   micros() has a 4us resolution on 16MHz boards, and costs a few us itself.
+*/
+class Profiler
+{
+public:
+    static void RecordEffect(unsigned int effectId, unsigned long duration);
+    static void RecordSubsystem(EProfileSubsystem subsystem, unsigned long duration);
+
+    static const ProfileStats* GetEffectStats(unsigned int effectId);
+    static const ProfileStats& GetSubsystemStats(EProfileSubsystem subsystem);
+
+    /* Prints one line per profiled entry: name, count, min, avg, max (us) then the histogram */
+    static void Report(Print& out);
+    static void Reset();
+private:
+    static void Record(ProfileStats& stats, unsigned long duration);
+    static void ReportEntry(Print& out, const ProfileStats& stats);
+};
+
+class ProfileScope
+{
+public:
+    ProfileScope(unsigned int effectId)
+        : m_Start(micros())
+        , m_EffectId(effectId)
+        , m_bEffect(true)
+    {
+    }
+
+    ProfileScope(EProfileSubsystem subsystem)
+        : m_Start(micros())
+        , m_EffectId(static_cast<unsigned int>(subsystem))
+        , m_bEffect(false)
+    {
+    }
+
+    ~ProfileScope()
+    {
+        const unsigned long duration = micros() - m_Start;
+        if(m_bEffect)   Profiler::RecordEffect(m_EffectId, duration);
+        else            Profiler::RecordSubsystem(static_cast<EProfileSubsystem>(m_EffectId), duration);
+    }
+private:
+    unsigned long m_Start;
+    unsigned int m_EffectId;
+    bool m_bEffect;
+};
+
+#ifdef PROFILE_MODE
+    #define PROFILE_EFFECT_SCOPE(effectId)      ProfileScope _profileEffectScope(static_cast<unsigned int>(effectId))
+    #define PROFILE_SUBSYSTEM_SCOPE(subsystem)  ProfileScope _profileSubsystemScope(subsystem)
+    #define PROFILE_REPORT(out)                 Profiler::Report(out)
+    #define PROFILE_RESET()                     Profiler::Reset()
+#else
+    #define PROFILE_EFFECT_SCOPE(effectId)
+    #define PROFILE_SUBSYSTEM_SCOPE(subsystem)
+    #define PROFILE_REPORT(out)
+    #define PROFILE_RESET()
+#endif // PROFILE_MODE
+
+#endif // !PROFILER_H
@@ -0,0 +1,166 @@
+#include "ProtocolFraming.h"
+
+#ifdef __AVR__
+    #include <util/crc16.h>
+#endif
+
+uint8_t Crc8(const uint8_t* data, size_t numBytes, uint8_t crc)
+{
+    for(size_t i = 0; i < numBytes; i++)
+    {
+    #ifdef __AVR__
+        crc = _crc8_ccitt_update(crc, data[i]);
+    #else
+        crc ^= data[i];
+        for(int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    #endif
+    }
+
+    return crc;
+}
+
+/* Streaming COBS encoder, data goes in a byte at a time without an intermediate packet buffer */
+struct CobsWriter
+{
+    uint8_t* Out;
+    size_t Pos;
+    size_t CodePos;
+    uint8_t Code;
+
+    CobsWriter(uint8_t* out)
+        : Out(out)
+        , Pos(1)
+        , CodePos(0)
+        , Code(1)
+    {
+    }
+
+    void Put(uint8_t b)
+    {
+        if(b != 0)
+        {
+            Out[Pos++] = b;
+            Code++;
+        }
+
+        // A zero, or a full block of 254 data bytes, closes the block
+        if(b == 0 || Code == 0xFF)
+        {
+            Out[CodePos] = Code;
+            CodePos = Pos++;
+            Code = 1;
+        }
+    }
+
+    size_t Finish()
+    {
+        Out[CodePos] = Code;
+        Out[Pos++] = 0;
+        return Pos;
+    }
+};
+
+size_t EncodePacket(EProtocolCommand command, const uint8_t* payload, size_t payloadSize, uint8_t* out, size_t outCapacity)
+{
+    if(payloadSize > PROTOCOL_MAX_PAYLOAD || (payloadSize > 0 && !payload))
+        return 0;
+
+    if(outCapacity < COBS_MAX_ENCODED(payloadSize + 3))
+        return 0;
+
+    const uint8_t header[2] = { (uint8_t)(payloadSize + 1), static_cast<uint8_t>(command) };
+    const uint8_t crc = Crc8(payload, payloadSize, Crc8(header, 2));
+
+    CobsWriter writer(out);
+    writer.Put(header[0]);
+    writer.Put(header[1]);
+    for(size_t i = 0; i < payloadSize; i++)
+    {
+        writer.Put(payload[i]);
+    }
+    writer.Put(crc);
+
+    return writer.Finish();
+}
+
+PacketDecoder::PacketDecoder()
+    : m_Size(0)
+    , m_CodeRemaining(0)
+    , m_bPendingZero(false)
+    , m_bDiscarding(false)
+    , m_NumErrors(0)
+    , m_NumPackets(0)
+{
+    m_Buffer[0] = 1;
+}
+
+bool PacketDecoder::Feed(uint8_t b)
+{
+    // Delimiter, the packet is complete
+    if(b == 0)
+    {
+        const bool bReceived = (m_Size > 0 || m_bDiscarding);
+        const bool bValid = !m_bDiscarding && m_CodeRemaining == 0 && Validate();
+
+        if(bValid)
+        {
+            m_NumPackets++;
+        }
+        else if(bReceived)
+        {
+            m_NumErrors++;
+        }
+
+        Restart();
+        return bValid;
+    }
+
+    if(m_bDiscarding)
+        return false;
+
+    // Code byte, tells us where the next zero lies. The zero closing the last block is implicit
+    if(m_CodeRemaining == 0)
+    {
+        if(m_bPendingZero && !Append(0))
+            return false;
+
+        m_CodeRemaining = b - 1;
+        m_bPendingZero = (b != 0xFF);
+        return false;
+    }
+
+    Append(b);
+    m_CodeRemaining--;
+    return false;
+}
+
+bool PacketDecoder::Append(uint8_t b)
+{
+    if(m_Size == PROTOCOL_MAX_PACKET)
+    {
+        m_bDiscarding = true;
+        return false;
+    }
+
+    m_Buffer[m_Size++] = b;
+    return true;
+}
+
+bool PacketDecoder::Validate() const
+{
+    if(m_Size < 3 || m_Buffer[0] == 0 || m_Size != m_Buffer[0] + 2)
+        return false;
+
+    return Crc8(m_Buffer, m_Size - 1) == m_Buffer[m_Size - 1];
+}
+
+void PacketDecoder::Restart()
+{
+    m_Size = 0;
+    m_CodeRemaining = 0;
+    m_bPendingZero = false;
+    m_bDiscarding = false;
+}
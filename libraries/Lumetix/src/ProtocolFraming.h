@@ -0,0 +1,99 @@
+#ifndef PROTOCOL_FRAMING_H
+#define PROTOCOL_FRAMING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*  Lumetix Protocol Framing
+*
+*   Every message is a packet of the form
+*
+*       [length][command][payload...][crc]
+*
+*   where length counts the command and payload bytes, and crc is a CRC-8 (polynomial 0x07, initial value 0)
+*   over length, command and payload. Packets are COBS encoded and terminated by a single 0x00, which never
+*   appears within an encoded packet. A receiver can therefore always resynchronize on the next 0x00, losing
+*   at most the packet that was corrupt.
+*
+*   This module has no Arduino dependencies, it is shared with the host tools.
+*/
+
+/* Largest payload of a single packet. Fits a full panel frame plus a sequence number */
+#define PROTOCOL_MAX_PAYLOAD 68
+
+/* Decoded packet: length, command, payload and crc */
+#define PROTOCOL_MAX_PACKET (PROTOCOL_MAX_PAYLOAD + 3)
+
+/* COBS adds a byte per 254 bytes of data (and one up front), plus our delimiter */
+#define COBS_MAX_ENCODED(numBytes) ((numBytes) + ((numBytes) / 254) + 2)
+#define PROTOCOL_MAX_ENCODED COBS_MAX_ENCODED(PROTOCOL_MAX_PACKET)
+
+enum class EProtocolCommand : uint8_t
+{
+    PING                = 0x01, // (payload...) replied with a PONG echoing the payload
+    PONG                = 0x02,
+
+    ACTIVATE_EFFECT     = 0x10, // (byte effectId, args...)
+    SET_EFFECT_ARGS     = 0x11, // (byte effectId, args...)
+    PUSH_EFFECT         = 0x12, // (byte effectId, byte priority, [byte blendMode])
+    REMOVE_EFFECT       = 0x13, // (byte effectId)
+    CLEAR_EFFECTS       = 0x14, // ()
+    SET_CROSSFADE       = 0x15, // (uint16 durationMs)
+
+    STREAM_FRAME        = 0x20, // ([uint16 sequence], byte frame[64]) starts streaming, see FrameStream.h
+    STREAM_STOP         = 0x21, // ()
+    STREAM_STATS        = 0x22, // () replied with (uint16 fpsX10, uint16 received, committed, stale, dropped, rejected)
+    STREAM_DELTA        = 0x23, // (uint16 sequence, uint16 baseSequence, byte encoding, delta...) see FrameCodec.h
+    STREAM_RESYNC       = 0x24, // (uint16 sequence) sent by the device when a delta's base is missing, the host sends a keyframe
+
+    PROFILE_QUERY       = 0x30, // () replied with a PROFILE_REPORT per profiled entry then an empty one, and resets the profiler
+    PROFILE_REPORT      = 0x31, // (byte entry, byte id, uint16 count, uint32 min, avg, max (us), uint16 histogram[]) see Profiler.h
+
+    TELEMETRY           = 0x40, // (byte record, uint16 timeMs, fields...) sent by the device, see TelemetrySchema.h
+    TELEMETRY_CONFIG    = 0x41  // (uint16 intervalMs) rate of periodic records, 0 turns telemetry off
+};
+
+uint8_t Crc8(const uint8_t* data, size_t numBytes, uint8_t crc = 0);
+
+/*  Builds an encoded packet, delimiter included, into out. Returns the number of bytes to transmit,
+*   or 0 if the payload is too large or out can not hold PROTOCOL_MAX_ENCODED bytes worth of this packet.
+*/
+size_t EncodePacket(EProtocolCommand command, const uint8_t* payload, size_t payloadSize, uint8_t* out, size_t outCapacity);
+
+/*  Packet Decoder
+*
+*   Incremental receiver: bytes are fed one at a time as they arrive, COBS is decoded on the fly and the
+*   packet is validated once its delimiter arrives. Never blocks and never needs more than one packet of RAM.
+*   A decoded packet is only valid until the next byte is fed.
+*/
+class PacketDecoder
+{
+public:
+    PacketDecoder();
+
+    /* Returns true once a complete and valid packet was received */
+    bool Feed(uint8_t b);
+
+    inline EProtocolCommand GetCommand() const { return static_cast<EProtocolCommand>(m_Buffer[1]); }
+    inline const uint8_t* GetPayload() const { return &m_Buffer[2]; }
+    inline size_t GetPayloadSize() const { return m_Buffer[0] - 1; }
+
+    /* Packets dropped for a bad length, crc or encoding, or for being too large */
+    inline uint16_t GetNumErrors() const { return m_NumErrors; }
+    inline uint16_t GetNumPackets() const { return m_NumPackets; }
+private:
+    bool Append(uint8_t b);
+    bool Validate() const;
+    void Restart();
+private:
+    uint8_t m_Buffer[PROTOCOL_MAX_PACKET];
+    uint8_t m_Size;
+
+    uint8_t m_CodeRemaining;    // Data bytes left in the current COBS block
+    bool m_bPendingZero;        // Current block ends with an encoded zero
+    bool m_bDiscarding;         // Packet is already known bad, skip to the next delimiter
+
+    uint16_t m_NumErrors;
+    uint16_t m_NumPackets;
+};
+#endif // !PROTOCOL_FRAMING_H
@@ -0,0 +1,250 @@
+#include "ProtocolHandler.h"
+
+#include "EffectRegistry.h"
+#include "FrameStream.h"
+#include "ByteCodec.h"
+#include "Profiler.h"
+#include "Telemetry.h"
+
+ProtocolHandler::ProtocolHandler(EffectRegistry& registry, FrameStream& stream, Print& reply)
+    : m_Registry(registry)
+    , m_Stream(stream)
+    , m_Reply(reply)
+    , m_ProfileEntry(0)
+    , m_bProfilePending(false)
+{
+}
+
+void ProtocolHandler::SendPacket(EProtocolCommand command, const byte* payload, size_t payloadSize)
+{
+    byte encoded[PROTOCOL_MAX_ENCODED];
+
+    const size_t numBytes = EncodePacket(command, payload, payloadSize, encoded, sizeof(encoded));
+    if(numBytes > 0)
+    {
+        // Leading delimiter, the host drops anything it received since the last packet (i.e debug prints)
+        m_Reply.write((uint8_t)0);
+        m_Reply.write(encoded, numBytes);
+    }
+}
+
+void ProtocolHandler::BeginStream()
+{
+    if(m_Stream.IsActive())
+        return;
+
+    // Streamed frames own the panel targets, effects would only fight over them. The cleared stack is composited
+    // right away so that it can not blank the first frame on the next registry update
+    m_Registry.ClearEffects();
+    m_Registry.FlushComposite();
+    m_Stream.Start();
+}
+
+void ProtocolHandler::ContinueProfileReport()
+{
+#ifdef PROFILE_MODE
+    const byte numSubsystems = static_cast<byte>(EProfileSubsystem::MAX_VAL);
+
+    // Photo effects and effects that never ran have nothing to report
+    while(m_ProfileEntry >= numSubsystems && m_ProfileEntry < numSubsystems + NUM_EFFECTS
+          && Profiler::GetEffectStats(m_ProfileEntry - numSubsystems)->Count == 0)
+    {
+        m_ProfileEntry++;
+    }
+
+    if(m_ProfileEntry < numSubsystems + NUM_EFFECTS)
+    {
+        const bool bSubsystem = (m_ProfileEntry < numSubsystems);
+        const byte id = (bSubsystem ? m_ProfileEntry : m_ProfileEntry - numSubsystems);
+        const ProfileStats& stats = (bSubsystem ? Profiler::GetSubsystemStats(static_cast<EProfileSubsystem>(id))
+                                                : *Profiler::GetEffectStats(id));
+
+        byte payload[2 + sizeof(uint16_t) + 3 * sizeof(uint32_t) + sizeof(stats.Histogram)];
+        ByteWriter writer(payload, sizeof(payload));
+        writer.PutByte(static_cast<byte>(bSubsystem ? EProfileEntry::SUBSYSTEM : EProfileEntry::EFFECT))
+              .PutByte(id)
+              .PutLE(stats.Count)
+              .PutLE((uint32_t)stats.Min)
+              .PutLE((uint32_t)(stats.Count > 0 ? stats.Total / stats.Count : 0))
+              .PutLE((uint32_t)stats.Max)
+              .PutArrayLE(stats.Histogram, PROFILE_HISTOGRAM_BINS);
+
+        SendPacket(EProtocolCommand::PROFILE_REPORT, payload, writer.GetPosition());
+        m_ProfileEntry++;
+        return;
+    }
+
+    Profiler::Reset();
+#endif // PROFILE_MODE
+
+    // Ends the report, and is the whole report when profiling is compiled out
+    SendPacket(EProtocolCommand::PROFILE_REPORT, nullptr, 0);
+    m_bProfilePending = false;
+}
+
+void ProtocolHandler::Dispatch()
+{
+    ByteReader reader(m_Decoder.GetPayload(), m_Decoder.GetPayloadSize());
+
+    switch(m_Decoder.GetCommand())
+    {
+        case EProtocolCommand::PING:
+        {
+            SendPacket(EProtocolCommand::PONG, m_Decoder.GetPayload(), m_Decoder.GetPayloadSize());
+        }
+        break;
+
+        case EProtocolCommand::ACTIVATE_EFFECT:
+        {
+            const byte effectId = reader.GetByte();
+            if(!reader.IsValid())
+                break;
+
+            const EffectArgs args(m_Decoder.GetPayload() + reader.GetPosition(), reader.GetRemaining());
+            m_Stream.Stop();
+            m_Registry.ActivateEffect(effectId);
+            m_Registry.NotifyArgsChanged(effectId, args);
+        }
+        break;
+
+        case EProtocolCommand::SET_EFFECT_ARGS:
+        {
+            const byte effectId = reader.GetByte();
+            if(!reader.IsValid())
+                break;
+
+            const EffectArgs args(m_Decoder.GetPayload() + reader.GetPosition(), reader.GetRemaining());
+            m_Registry.NotifyArgsChanged(effectId, args);
+        }
+        break;
+
+        case EProtocolCommand::PUSH_EFFECT:
+        {
+            const byte effectId = reader.GetByte();
+            const byte priority = reader.GetByte();
+            const byte blendMode = (reader.GetRemaining() > 0 ? reader.GetByte() : static_cast<byte>(EUpdateMode::ADD));
+
+            if(reader.IsValid() && blendMode <= static_cast<byte>(EUpdateMode::IGNORE_NONZERO))
+            {
+                m_Stream.Stop();
+                m_Registry.PushEffect(effectId, priority, static_cast<EUpdateMode>(blendMode));
+            }
+        }
+        break;
+
+        case EProtocolCommand::REMOVE_EFFECT:
+        {
+            const byte effectId = reader.GetByte();
+            if(reader.IsValid())
+            {
+                m_Registry.RemoveEffect(effectId);
+            }
+        }
+        break;
+
+        case EProtocolCommand::CLEAR_EFFECTS:
+        {
+            m_Registry.ClearEffects();
+        }
+        break;
+
+        case EProtocolCommand::SET_CROSSFADE:
+        {
+            const uint16_t durationMs = reader.GetLE<uint16_t>();
+            if(reader.IsValid())
+            {
+                m_Registry.SetCrossfadeDuration(durationMs / 1000.f);
+            }
+        }
+        break;
+
+        case EProtocolCommand::STREAM_FRAME:
+        {
+            const size_t payloadSize = m_Decoder.GetPayloadSize();
+            const bool bHasSequence = (payloadSize == NUM_LEDS + sizeof(uint16_t));
+
+            if(payloadSize != NUM_LEDS && !bHasSequence)
+                break;
+
+            BeginStream();
+
+            if(bHasSequence)
+            {
+                const uint16_t sequence = reader.GetLE<uint16_t>();
+                m_Stream.Receive(m_Decoder.GetPayload() + reader.GetPosition(), sequence);
+            }
+            else
+            {
+                m_Stream.Receive(m_Decoder.GetPayload());
+            }
+        }
+        break;
+
+        case EProtocolCommand::STREAM_DELTA:
+        {
+            const uint16_t sequence = reader.GetLE<uint16_t>();
+            const uint16_t baseSequence = reader.GetLE<uint16_t>();
+            const byte encoding = reader.GetByte();
+
+            if(!reader.IsValid() || encoding >= static_cast<byte>(EFrameEncoding::MAX_VAL))
+                break;
+
+            BeginStream();
+
+            const EDeltaResult result = m_Stream.ReceiveDelta(sequence, baseSequence, static_cast<EFrameEncoding>(encoding)
+                                                            , m_Decoder.GetPayload() + reader.GetPosition(), reader.GetRemaining());
+            if(result == EDeltaResult::MISSING_BASE)
+            {
+                byte payload[sizeof(uint16_t)];
+                StoreLE(payload, sequence);
+                SendPacket(EProtocolCommand::STREAM_RESYNC, payload, sizeof(payload));
+            }
+        }
+        break;
+
+        case EProtocolCommand::STREAM_STOP:
+        {
+            m_Stream.Stop();
+        }
+        break;
+
+        case EProtocolCommand::STREAM_STATS:
+        {
+            const FrameStreamStats& stats = m_Stream.GetStats();
+
+            byte payload[6 * sizeof(uint16_t)];
+            ByteWriter writer(payload, sizeof(payload));
+            writer.PutLE(stats.FpsX10)
+                  .PutLE(stats.NumReceived)
+                  .PutLE(stats.NumCommitted)
+                  .PutLE(stats.NumStale)
+                  .PutLE(stats.NumDropped)
+                  .PutLE(stats.NumRejected);
+
+            SendPacket(EProtocolCommand::STREAM_STATS, payload, writer.GetPosition());
+        }
+        break;
+
+        case EProtocolCommand::PROFILE_QUERY:
+        {
+            // Restarts a report that is still going out
+            m_ProfileEntry = 0;
+            m_bProfilePending = true;
+        }
+        break;
+
+        case EProtocolCommand::TELEMETRY_CONFIG:
+        {
+            const uint16_t intervalMs = reader.GetLE<uint16_t>();
+            if(reader.IsValid())
+            {
+                Telemetry::SetInterval(intervalMs);
+            }
+        }
+        break;
+
+        default:
+            LOG("Unknown command: "); LOGN(static_cast<byte>(m_Decoder.GetCommand()));
+        break;
+    }
+}
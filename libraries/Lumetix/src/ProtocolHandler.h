@@ -0,0 +1,72 @@
+#ifndef PROTOCOL_HANDLER_H
+#define PROTOCOL_HANDLER_H
+
+#include <Arduino.h>
+
+#include "ProtocolFraming.h"
+#include "ByteRing.h"
+
+class EffectRegistry;
+class FrameStream;
+
+/*  Protocol Handler
+*
+*   Receiving end of the Lumetix protocol (see ProtocolFraming.h). Received bytes are decoded in place,
+*   straight from the serial ring, and complete commands are dispatched to the EffectRegistry, or to the
+*   FrameStream for host-driven video. Streaming and effects are exclusive: the first streamed frame clears
+*   all effects, activating or pushing an effect stops the stream.
+*   Process never waits on the serial port: partial packets simply resume on the next call.
+*   Replies, if any, are written as encoded packets to the reply stream. Profiler reports span several packets,
+*   they are sent one per Process so that a report never stalls the loop on a full serial buffer.
+*/
+class ProtocolHandler
+{
+public:
+    ProtocolHandler(EffectRegistry& registry, FrameStream& stream, Print& reply);
+
+    template<size_t Capacity>
+    void Process(ByteRing<Capacity>& ring);
+
+    void SendPacket(EProtocolCommand command, const byte* payload, size_t payloadSize);
+
+    inline const PacketDecoder& GetDecoder() const { return m_Decoder; }
+private:
+    void Dispatch();
+    void BeginStream();
+
+    /* Sends the next entry of a pending profiler report, the empty packet that ends it once all entries are out */
+    void ContinueProfileReport();
+private:
+    EffectRegistry& m_Registry;
+    FrameStream& m_Stream;
+    Print& m_Reply;
+    PacketDecoder m_Decoder;
+
+    /* Next profiler entry to report, subsystems first then effects */
+    byte m_ProfileEntry;
+    bool m_bProfilePending;
+};
+
+template<size_t Capacity>
+void ProtocolHandler::Process(ByteRing<Capacity>& ring)
+{
+    // At most two spans, before and after the ring wraps around
+    for(ByteSpan span = ring.PeekSpan(); span.Size > 0; span = ring.PeekSpan())
+    {
+        for(size_t i = 0; i < span.Size; i++)
+        {
+            if(m_Decoder.Feed(span.Data[i]))
+            {
+                Dispatch();
+            }
+        }
+
+        ring.Release(span.Size);
+    }
+
+    if(m_bProfilePending)
+    {
+        ContinueProfileReport();
+    }
+}
+#endif // !PROTOCOL_HANDLER_H
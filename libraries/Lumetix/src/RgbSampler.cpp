@@ -0,0 +1,110 @@
+#include "RgbSampler.h"
+
+#include "Common.h"
+#include "Profiler.h"
+
+volatile bool RgbSampler::s_bConversionDone = false;
+
+// Conversions take ~100ms per color, polling the status faster than this is wasted I2C traffic
+const unsigned long RgbSampler::s_PollInterval = 25;
+
+RgbSampler::RgbSampler(RGBSensor& sensor)
+    : m_Sensor(sensor)
+    , m_Head(0)
+    , m_Sequence(0)
+    , m_LastPollTime(0)
+    , m_bUsesInterrupt(false)
+{
+    for(int i = 0; i < RGB_SAMPLE_HISTORY; i++)
+    {
+        m_Samples[i] = { 0, 0, 0, 0 };
+    }
+}
+
+bool RgbSampler::Init(int interruptPin)
+{
+    // Same configuration as SFE_ISL29125::init(), but the interrupt flag now signals conversion completion
+    bool bSuccess = m_Sensor.config(CFG1_MODE_RGB | CFG1_10KLUX, CFG2_IR_ADJUST_HIGH, CFG3_RGB_CONV_TO_INT_ENABLE);
+
+    if(interruptPin >= 0)
+    {
+        // INT line is open drain and active low
+        pinMode(interruptPin, INPUT_PULLUP);
+        attachInterrupt(digitalPinToInterrupt(interruptPin), &RgbSampler::OnConversionDone, FALLING);
+        m_bUsesInterrupt = true;
+    }
+
+    // Clears any pending flag so that the first sample we fetch is a complete conversion
+    m_Sensor.readStatus();
+    m_LastPollTime = millis();
+
+    LOG("RgbSampler Init: "); LOGN(bSuccess);
+    return bSuccess;
+}
+
+void RgbSampler::Update()
+{
+    PROFILE_SUBSYSTEM_SCOPE(EProfileSubsystem::SAMPLER_UPDATE);
+
+    if(m_bUsesInterrupt)
+    {
+        if(!s_bConversionDone)
+            return;
+
+        s_bConversionDone = false;
+
+        // Reading the status register releases the INT line
+        m_Sensor.readStatus();
+        FetchSample();
+        return;
+    }
+
+    const unsigned long now = millis();
+    if(now - m_LastPollTime < s_PollInterval)
+        return;
+
+    m_LastPollTime = now;
+
+    // Interrupt flag is raised on conversion completion, and cleared by reading the status
+    if(m_Sensor.readStatus() & FLAG_INT)
+    {
+        FetchSample();
+    }
+}
+
+bool RgbSampler::ConsumeLatest(uint16_t& inOutCursor, RgbSample& outSample) const
+{
+    if(m_Sequence == 0 || inOutCursor == m_Sequence)
+        return false;
+
+    outSample = m_Samples[m_Head];
+    inOutCursor = m_Sequence;
+    return true;
+}
+
+const RgbSample& RgbSampler::GetSample(uint8_t age) const
+{
+    return m_Samples[(m_Head - age) & (RGB_SAMPLE_HISTORY - 1)];
+}
+
+void RgbSampler::FetchSample()
+{
+    m_Head = (m_Head + 1) & (RGB_SAMPLE_HISTORY - 1);
+
+    RgbSample& sample = m_Samples[m_Head];
+    sample.Red          = m_Sensor.readRed();
+    sample.Green        = m_Sensor.readGreen();
+    sample.Blue         = m_Sensor.readBlue();
+    sample.Timestamp    = millis();
+
+    // 0 is reserved for "no samples yet", consumers start with a zeroed cursor
+    if(++m_Sequence == 0)
+    {
+        m_Sequence = 1;
+    }
+}
+
+void RgbSampler::OnConversionDone()
+{
+    s_bConversionDone = true;
+}
@@ -0,0 +1,71 @@
+#ifndef RGB_SAMPLER_H
+#define RGB_SAMPLER_H
+
+#include <Arduino.h>
+#include "../../SparkFun_ISL29125_Breakout_Arduino_Library-master/src/SparkFunISL29125.h"
+
+typedef SFE_ISL29125 RGBSensor;
+
+/* Must be a power of two, we wrap indices with a mask */
+#define RGB_SAMPLE_HISTORY 4
+
+struct RgbSample
+{
+    uint16_t Red;
+    uint16_t Green;
+    uint16_t Blue;
+    unsigned long Timestamp; // millis() at which the sample was fetched from the sensor
+};
+
+/*  RGB Sampler
+*
+*   Non-blocking sampling pipeline for the ISL29125. The sensor is configured to raise its interrupt
+*   flag whenever an RGB conversion completes (~100ms per color at 16 bit), and each conversion is
+*   fetched from the sensor exactly once into a small timestamped ring buffer.
+*
+*   If an interrupt pin is provided, the sensor's INT line tells us when a conversion is done. Otherwise,
+*   the status register is polled at a low rate, which is a single byte read instead of three read16 calls.
+*
+*   Consumers keep their own cursor (the last sequence number they have seen) and only receive
+*   samples that are new to them, so they can skip their processing entirely when nothing changed.
+*/
+class RgbSampler
+{
+public:
+    RgbSampler(RGBSensor& sensor);
+
+    /* Configures the sensor for conversion-done interrupts. Call after the sensor was initialized. */
+    bool Init(int interruptPin = -1);
+
+    /* Services the sensor, fetching a sample if a new conversion is available. Call every application update. */
+    void Update();
+
+    /*  Retrieves the latest sample if it is newer than the given cursor, and advances the cursor.
+    *   Returns false if the consumer has already seen the latest sample.
+    */
+    bool ConsumeLatest(uint16_t& inOutCursor, RgbSample& outSample) const;
+
+    /* Returns a previously fetched sample, where age 0 is the latest one. */
+    const RgbSample& GetSample(uint8_t age = 0) const;
+
+    inline uint16_t GetSequence() const { return m_Sequence; }
+    inline bool HasSamples() const { return m_Sequence != 0; }
+private:
+    void FetchSample();
+    static void OnConversionDone();
+private:
+    RGBSensor& m_Sensor;
+
+    RgbSample m_Samples[RGB_SAMPLE_HISTORY];
+
+    /* Index of the latest sample, and a running count of fetched samples (never 0 once a sample exists) */
+    uint8_t m_Head;
+    uint16_t m_Sequence;
+
+    unsigned long m_LastPollTime;
+    bool m_bUsesInterrupt;
+
+    static volatile bool s_bConversionDone;
+    static const unsigned long s_PollInterval; // ms
+};
+#endif // !RGB_SAMPLER_H
@@ -0,0 +1,79 @@
+#include "SignalConditioner.h"
+
+#include "Common.h"
+
+#define FIXED_SHIFT 16
+
+SignalConditioner::SignalConditioner(byte smoothingShift, float hysteresis)
+    : m_Average(0)
+    , m_Committed(0)
+    , m_Hysteresis(ToFixed(hysteresis))
+    , m_SmoothingShift(smoothingShift)
+    , m_bPrimed(false)
+{
+}
+
+bool SignalConditioner::Push(float sample)
+{
+    const long fixedSample = ToFixed(sample);
+
+    if(!m_bPrimed)
+    {
+        m_Average = fixedSample;
+        m_Committed = fixedSample;
+        m_bPrimed = true;
+        return true;
+    }
+
+    // Arithmetic shift, negative errors round towards -inf which is fine for our purposes
+    m_Average += (fixedSample - m_Average) >> m_SmoothingShift;
+
+    const long delta = m_Average - m_Committed;
+    if(delta > m_Hysteresis || delta < -m_Hysteresis)
+    {
+        m_Committed = m_Average;
+        return true;
+    }
+
+    return false;
+}
+
+void SignalConditioner::Reset()
+{
+    m_bPrimed = false;
+}
+
+void SignalConditioner::SetSmoothing(byte smoothingShift)
+{
+    m_SmoothingShift = smoothingShift;
+}
+
+void SignalConditioner::SetHysteresis(float hysteresis)
+{
+    m_Hysteresis = ToFixed(Abs(hysteresis));
+}
+
+float SignalConditioner::GetValue() const
+{
+    return FromFixed(m_Committed);
+}
+
+float SignalConditioner::GetSmoothedValue() const
+{
+    return FromFixed(m_Average);
+}
+
+long SignalConditioner::ToFixed(float val)
+{
+    // Ratios with a zero denominator give us NaN or infinities, the clamp catches the latter
+    if(val != val)
+        val = 0.f;
+
+    const float scaled = Clamp(val, -32767.f, 32767.f) * (float)(1L << FIXED_SHIFT);
+    return (long)scaled;
+}
+
+float SignalConditioner::FromFixed(long val)
+{
+    return (float)val / (float)(1L << FIXED_SHIFT);
+}
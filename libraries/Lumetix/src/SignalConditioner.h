@@ -0,0 +1,47 @@
+#ifndef SIGNAL_CONDITIONER_H
+#define SIGNAL_CONDITIONER_H
+
+#include <Arduino.h>
+
+/*  Signal Conditioner
+*
+*   Smooths a noisy input (i.e sensor ratios shimmering with ambient flicker) using a fixed-point
+*   exponential moving average, then applies a hysteresis band on the smoothed signal. The conditioned
+*   value is only committed, and reported as changed, once it moves past the band from the last committed value.
+*
+*   Values are stored in Q16.16, so inputs are expected within +/- 32767.
+*
+*   Smoothing is expressed as a shift: each sample moves the average by 1/(2^shift) of the error.
+*   A shift of 0 disables smoothing, 2 is a good default for ~10 samples/second.
+*/
+class SignalConditioner
+{
+public:
+    SignalConditioner(byte smoothingShift = 2, float hysteresis = 0.f);
+
+    /* Feeds a raw sample. Returns true if the committed value changed as a result */
+    bool Push(float sample);
+
+    /* Forgets all history, the next sample is committed as is */
+    void Reset();
+
+    void SetSmoothing(byte smoothingShift);
+    void SetHysteresis(float hysteresis);
+
+    /* The last committed value, this is what consumers should respond to */
+    float GetValue() const;
+
+    /* The smoothed value, which may still lie within the hysteresis band */
+    float GetSmoothedValue() const;
+private:
+    static long ToFixed(float val);
+    static float FromFixed(long val);
+private:
+    long m_Average;     // Q16.16
+    long m_Committed;   // Q16.16
+    long m_Hysteresis;  // Q16.16
+
+    byte m_SmoothingShift;
+    bool m_bPrimed;
+};
+#endif // !SIGNAL_CONDITIONER_H
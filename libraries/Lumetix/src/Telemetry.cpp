@@ -0,0 +1,83 @@
+#include "Telemetry.h"
+#include "ByteRing.h"
+
+static ByteRing<TELEMETRY_TX_CAPACITY> s_TxRing;
+
+uint16_t Telemetry::s_Interval = 0;
+uint16_t Telemetry::s_NumDropped = 0;
+uint16_t Telemetry::s_LastSent[static_cast<int>(ETelemetryRecord::MAX_VAL)];
+
+void Telemetry::SetInterval(uint16_t intervalMs)
+{
+    s_Interval = intervalMs;
+
+    // Whatever was queued is stale by the time telemetry is turned on again
+    if(intervalMs == 0)
+    {
+        s_TxRing.Clear();
+    }
+}
+
+bool Telemetry::IsDue(ETelemetryRecord record)
+{
+    if(s_Interval == 0)
+        return false;
+
+    // 16 bit timestamps, fine for intervals below a minute
+    const uint16_t now = (uint16_t)millis();
+    return (uint16_t)(now - s_LastSent[static_cast<int>(record)]) >= s_Interval;
+}
+
+bool Telemetry::Send(ETelemetryRecord record, const byte* fields, size_t numBytes)
+{
+    if(s_Interval == 0 || numBytes > TELEMETRY_MAX_RECORD - TELEMETRY_HEADER_SIZE)
+        return false;
+
+    const uint16_t now = (uint16_t)millis();
+    s_LastSent[static_cast<int>(record)] = now;
+
+    byte payload[TELEMETRY_MAX_RECORD];
+    payload[0] = static_cast<byte>(record);
+    StoreLE(&payload[1], now);
+    memcpy(&payload[TELEMETRY_HEADER_SIZE], fields, numBytes);
+
+    byte encoded[COBS_MAX_ENCODED(TELEMETRY_MAX_RECORD + 3)];
+    const size_t numEncoded = EncodePacket(EProtocolCommand::TELEMETRY, payload, TELEMETRY_HEADER_SIZE + numBytes, encoded, sizeof(encoded));
+
+    // Whole packets only, a truncated one would also corrupt the next
+    if(numEncoded == 0 || numEncoded > s_TxRing.GetFree())
+    {
+        s_NumDropped++;
+        return false;
+    }
+
+    s_TxRing.Write(encoded, numEncoded);
+    return true;
+}
+
+void Telemetry::Flush(HardwareSerial& serial)
+{
+    while(s_TxRing.GetAvailable() > 0)
+    {
+        // Packets end with their delimiter, the only zero within the packet
+        size_t packetSize = 1;
+        while(s_TxRing.Peek(packetSize - 1) != 0)
+        {
+            packetSize++;
+        }
+
+        if((size_t)serial.availableForWrite() < packetSize)
+            return;
+
+        // At most two spans, before and after the wrap around
+        while(packetSize > 0)
+        {
+            const ByteSpan span = s_TxRing.PeekSpan();
+            const size_t numBytes = (span.Size < packetSize ? span.Size : packetSize);
+
+            serial.write(span.Data, numBytes);
+            s_TxRing.Release(numBytes);
+            packetSize -= numBytes;
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "ByteCodec.h"
+#include "ProtocolFraming.h"
+#include "TelemetrySchema.h"
+
+/* Encoded records waiting for the UART. Holds a few records, overflowing records are dropped, never waited on */
+#define TELEMETRY_TX_CAPACITY 64
+
+/* Largest record payload, header included */
+#define TELEMETRY_MAX_RECORD 16
+
+/*  Telemetry
+*
+*   Binary replacement for diagnostic prints on the hot path. Records are a few fixed point fields (see
+*   TelemetrySchema.h), encoded as TELEMETRY packets of the serial protocol into a TX ring. Flush moves whole
+*   packets to the UART only when its TX buffer has room for them, so sending telemetry never blocks the
+*   loop, and never splits a packet around a reply the ProtocolHandler writes in between.
+*
+*   Periodic records are rate limited: check IsDue before gathering the fields, records are sent at most once
+*   per interval each. Event records (i.e calibration steps) only check IsEnabled. Telemetry is off until an
+*   interval is set, either by the sketch or by the host with TELEMETRY_CONFIG.
+*/
+class Telemetry
+{
+public:
+    /* Minimum time between two periodic records of the same id, 0 disables telemetry altogether */
+    static void SetInterval(uint16_t intervalMs);
+    static inline uint16_t GetInterval() { return s_Interval; }
+    static inline bool IsEnabled() { return s_Interval != 0; }
+
+    static bool IsDue(ETelemetryRecord record);
+
+    /* Queues a record built with TelemetryRecord. Returns false if it was dropped */
+    static bool Send(ETelemetryRecord record, const byte* fields, size_t numBytes);
+
+    /* Call once per loop */
+    static void Flush(HardwareSerial& serial);
+
+    /* Records dropped because the ring was full */
+    static inline uint16_t GetNumDropped() { return s_NumDropped; }
+private:
+    static uint16_t s_Interval;
+    static uint16_t s_NumDropped;
+    static uint16_t s_LastSent[static_cast<int>(ETelemetryRecord::MAX_VAL)];
+};
+
+/*  Fields of a single record, in schema order:
+*
+*       if(Telemetry::IsDue(ETelemetryRecord::PARTY))
+*       {
+*           TelemetryRecord(ETelemetryRecord::PARTY).PutU8(animation).PutU16(delayMs).Send();
+*       }
+*/
+class TelemetryRecord
+{
+public:
+    TelemetryRecord(ETelemetryRecord record)
+        : m_Record(record)
+        , m_Writer(m_Fields, sizeof(m_Fields))
+    {
+    }
+
+    inline TelemetryRecord& PutU8(uint8_t value) { m_Writer.PutByte(value); return *this; }
+    inline TelemetryRecord& PutU16(uint16_t value) { m_Writer.PutLE(value); return *this; }
+    inline TelemetryRecord& PutQ8_8(float value) { m_Writer.PutLE(ToQ8_8(value)); return *this; }
+    inline TelemetryRecord& PutUQ0_16(float value) { m_Writer.PutLE(ToUQ0_16(value)); return *this; }
+
+    inline bool Send() { return m_Writer.IsValid() && Telemetry::Send(m_Record, m_Fields, m_Writer.GetPosition()); }
+private:
+    ETelemetryRecord m_Record;
+    byte m_Fields[TELEMETRY_MAX_RECORD - TELEMETRY_HEADER_SIZE];
+    ByteWriter m_Writer;
+};
+#endif // !TELEMETRY_H
@@ -0,0 +1,56 @@
+#include "TelemetrySchema.h"
+
+static const TelemetryFieldInfo s_SensorFields[] =
+{
+    { "red",        ETelemetryField::U16 },
+    { "green",      ETelemetryField::U16 },
+    { "blue",       ETelemetryField::U16 },
+    { "invRedf",    ETelemetryField::Q8_8 },
+    { "rawRBf",     ETelemetryField::Q8_8 }
+};
+
+static const TelemetryFieldInfo s_ColorResponseFields[] =
+{
+    { "RBf",        ETelemetryField::Q8_8 },
+    { "rangeMax",   ETelemetryField::Q8_8 },
+    { "t",          ETelemetryField::UQ0_16 },
+    { "cool",       ETelemetryField::UQ0_16 },
+    { "warm",       ETelemetryField::UQ0_16 },
+    { "red",        ETelemetryField::UQ0_16 }
+};
+
+static const TelemetryFieldInfo s_PartyFields[] =
+{
+    { "animation",  ETelemetryField::U8 },
+    { "bpmDelayMs", ETelemetryField::U16 }
+};
+
+static const TelemetryFieldInfo s_CalibrationFields[] =
+{
+    { "state",      ETelemetryField::U8 },
+    { "numSamples", ETelemetryField::U8 },
+    { "rangeMax",   ETelemetryField::Q8_8 }
+};
+
+#define RECORD_INFO(name, fields) { name, fields, sizeof(fields) / sizeof(fields[0]) }
+
+/* Indexed by record id - 1 */
+static const TelemetryRecordInfo s_Records[] =
+{
+    RECORD_INFO("sensor", s_SensorFields),
+    RECORD_INFO("color_response", s_ColorResponseFields),
+    RECORD_INFO("party", s_PartyFields),
+    RECORD_INFO("calibration", s_CalibrationFields)
+};
+
+static_assert(sizeof(s_Records) / sizeof(s_Records[0]) == static_cast<size_t>(ETelemetryRecord::MAX_VAL) - 1, "Every telemetry record needs its info");
+
+const TelemetryRecordInfo* GetTelemetryRecordInfo(uint8_t recordId)
+{
+    return (recordId >= 1 && recordId < static_cast<uint8_t>(ETelemetryRecord::MAX_VAL) ? &s_Records[recordId - 1] : nullptr);
+}
+
+size_t GetTelemetryFieldSize(ETelemetryField type)
+{
+    return (type == ETelemetryField::U8 ? 1 : 2);
+}
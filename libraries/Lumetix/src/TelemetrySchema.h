@@ -0,0 +1,74 @@
+#ifndef TELEMETRY_SCHEMA_H
+#define TELEMETRY_SCHEMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*  Telemetry Schema
+*
+*   Every TELEMETRY packet carries a single record:
+*
+*       [byte recordId][uint16 timeMs][fields...]
+*
+*   where timeMs are the low 16 bits of millis() when the record was sent, and fields are little endian,
+*   packed back to back in the order listed below. Record ids are fixed, new records get new ids so that
+*   older decoders can skip what they do not know.
+*
+*   This module has no Arduino dependencies, it is shared with the host tools. The firmware only needs the
+*   ids and the fixed point conversions, the name tables are only linked into whatever decodes records.
+*/
+
+/* Record id and timestamp */
+#define TELEMETRY_HEADER_SIZE 3
+
+enum class ETelemetryRecord : uint8_t
+{
+    SENSOR          = 0x01, // (uint16 red, uint16 green, uint16 blue, q8.8 invRedf, q8.8 rawRBf)
+    COLOR_RESPONSE  = 0x02, // (q8.8 RBf, q8.8 rangeMax, uq0.16 t, uq0.16 cool, uq0.16 warm, uq0.16 red)
+    PARTY           = 0x03, // (u8 animation, uint16 bpmDelayMs)
+    CALIBRATION     = 0x04, // (u8 state, u8 numSamples, q8.8 rangeMax) event, sent for every change
+    MAX_VAL
+};
+
+enum class ETelemetryField : uint8_t
+{
+    U8,
+    U16,
+    Q8_8,   // int16, value * 256. [-128, 128) in steps of 1/256
+    UQ0_16, // uint16, value * 65535. [0, 1], for normalized parameters and responses
+    MAX_VAL
+};
+
+struct TelemetryFieldInfo
+{
+    const char* Name;
+    ETelemetryField Type;
+};
+
+struct TelemetryRecordInfo
+{
+    const char* Name;
+    const TelemetryFieldInfo* Fields;
+    uint8_t NumFields;
+};
+
+/* Null for unknown records */
+const TelemetryRecordInfo* GetTelemetryRecordInfo(uint8_t recordId);
+
+size_t GetTelemetryFieldSize(ETelemetryField type);
+
+/* Conversions saturate instead of wrapping around */
+inline int16_t ToQ8_8(float value)
+{
+    const float scaled = value * 256.f;
+    return (scaled >= 32767.f ? 32767 : scaled <= -32768.f ? -32768 : (int16_t)(scaled + (scaled >= 0 ? 0.5f : -0.5f)));
+}
+
+inline uint16_t ToUQ0_16(float value)
+{
+    return (value >= 1.f ? 0xFFFF : value <= 0.f ? 0 : (uint16_t)(value * 65535.f + 0.5f));
+}
+
+inline float FromQ8_8(int16_t value) { return value / 256.f; }
+inline float FromUQ0_16(uint16_t value) { return value / 65535.f; }
+#endif // !TELEMETRY_SCHEMA_H
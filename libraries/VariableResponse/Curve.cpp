@@ -1,7 +1,8 @@
 #include "Curve.h"
 #include <assert.h>
+#include <math.h>
+#include <avr/pgmspace.h>
 //#include <cstring>
-#include <HardwareSerial.h>
 
 /* Because we can't include cstring for some reason. Thanks Arduino */
 static void* memcpy(void* dest, void* src, size_t len)
@@ -13,6 +14,18 @@ static void* memcpy(void* dest, void* src, size_t len)
     return dest;
 }
 
+/* Key sources of the segment math below, picked by key type: curves read their keys from RAM, views from flash */
+static inline Key ReadKey(const Key* keys, int atIdx)
+{
+    return keys[atIdx];
+}
+
+static inline Key ReadKey(const FlashKey* keys, int atIdx)
+{
+    Key k = { pgm_read_float(&keys[atIdx].Alpha), pgm_read_float(&keys[atIdx].Value) };
+    return k;
+}
+
 namespace Interp
 {
     static float Lerp(float p1, float p2, float alpha)
@@ -20,25 +33,175 @@ namespace Interp
         return ((1 - alpha)*p1 + alpha*p2);
     }
 
-    static float Cubic(float p0, float p1, float p2, float p3, float alpha)
+    /* Index of the key starting the segment containing t, clamped to the first and last segments */
+    template<class TKey>
+    static int FindSegment(const TKey* keys, int numKeys, int& cursor, float t)
     {
-        // Recall catmull rom spline
-        /*
-        *   f(0) = p1
-        *   f(1) = p2
-        *   f'(0) = (p2-p0) * 0.5
-        *   f'(1) = (p3-p1) * 0.5
-        */
-
-        return alpha*alpha*alpha*(-0.5f*p0 + 1.5f*p1 - 1.5f*p2 + 0.5f*p3)
-            + alpha*alpha*(p0 - 2.5f*p1 + 2 * p2 - 0.5f*p3)
-            + alpha*(-0.5f*p0 + 0.5f*p2)
-            + p1;
+        const int lastSegment = numKeys - 2;
+
+        // Outside the keys, the curve holds its end values
+        if(t <= ReadKey(keys, 0).Alpha)
+            return 0;
+        if(t >= ReadKey(keys, numKeys - 1).Alpha)
+            return lastSegment;
+
+        // Monitored values change slowly, consecutive evaluations mostly land in the same or a neighbouring segment
+        const int last = cursor;
+        if(last <= lastSegment && ReadKey(keys, last).Alpha <= t)
+        {
+            if(t < ReadKey(keys, last + 1).Alpha)
+                return last;
+
+            if(last + 1 <= lastSegment && t < ReadKey(keys, last + 2).Alpha)
+                return (cursor = last + 1);
+        }
+        else if(last > 0 && last <= lastSegment + 1 && ReadKey(keys, last - 1).Alpha <= t && t < ReadKey(keys, last).Alpha)
+        {
+            return (cursor = last - 1);
+        }
+
+        // Keys[low].Alpha <= t < Keys[high].Alpha
+        int low = 0;
+        int high = numKeys - 1;
+        while(high - low > 1)
+        {
+            const int mid = (low + high) / 2;
+            if(ReadKey(keys, mid).Alpha <= t)
+                low = mid;
+            else
+                high = mid;
+        }
+
+        return (cursor = low);
     }
+
+    /* Slope at a key, limited so that segments on either side stay monotone */
+    template<class TKey>
+    static float ComputeTangent(const TKey* keys, int numKeys, int atIdx)
+    {
+        const int last = numKeys - 1;
+        const Key k = ReadKey(keys, atIdx);
+
+        // Secants of the segments before and after the key, coincident keys have no slope
+        float h0 = 0.f, h1 = 0.f, d0 = 0.f, d1 = 0.f;
+        if(atIdx > 0)
+        {
+            const Key prev = ReadKey(keys, atIdx - 1);
+            h0 = k.Alpha - prev.Alpha;
+            d0 = (h0 > 0.f ? (k.Value - prev.Value) / h0 : 0.f);
+        }
+        if(atIdx < last)
+        {
+            const Key next = ReadKey(keys, atIdx + 1);
+            h1 = next.Alpha - k.Alpha;
+            d1 = (h1 > 0.f ? (next.Value - k.Value) / h1 : 0.f);
+        }
+
+        if(atIdx > 0 && atIdx < last)
+        {
+            // Flat at local extrema, otherwise a weighted harmonic mean of the secants, which keeps the
+            // tangents within the 3 * secant bound of Fritsch-Carlson on both segments
+            if(d0 * d1 <= 0.f)
+                return 0.f;
+
+            const float w0 = 2.f * h1 + h0;
+            const float w1 = h1 + 2.f * h0;
+            return (w0 + w1) / (w0 / d0 + w1 / d1);
+        }
+
+        // End keys: one sided three point estimate, limited the same way
+        const float d = (atIdx == 0 ? d1 : d0);
+        if(numKeys < 3)
+            return d;
+
+        const Key inner = ReadKey(keys, atIdx == 0 ? 1 : last - 1);
+        const Key outer = ReadKey(keys, atIdx == 0 ? 2 : last - 2);
+        const float hNear = (atIdx == 0 ? h1 : h0);
+        const float hFar = (atIdx == 0 ? outer.Alpha - inner.Alpha : inner.Alpha - outer.Alpha);
+        const float dFar = (hFar > 0.f ? (atIdx == 0 ? outer.Value - inner.Value : inner.Value - outer.Value) / hFar : 0.f);
+        if(hNear + hFar <= 0.f)
+            return d;
+
+        const float tangent = ((2.f * hNear + hFar) * d - hNear * dFar) / (hNear + hFar);
+        if(tangent * d <= 0.f)
+            return 0.f;
+        if(d * dFar < 0.f && fabsf(tangent) > fabsf(3.f * d))
+            return 3.f * d;
+        return tangent;
+    }
+
+    template<class TKey>
+    static CurveSegment ComputeSegment(const TKey* keys, int numKeys, int begin)
+    {
+        const Key k1 = ReadKey(keys, begin);
+        const Key k2 = ReadKey(keys, begin + 1);
+
+        // Hermite basis expanded into a polynomial of the local parameter, tangents scaled to the segment width
+        const float width = k2.Alpha - k1.Alpha;
+        const float delta = k2.Value - k1.Value;
+        const float m1 = width * ComputeTangent(keys, numKeys, begin);
+        const float m2 = width * ComputeTangent(keys, numKeys, begin + 1);
+
+        CurveSegment segment;
+        segment.C1 = m1;
+        segment.C2 = 3.f * delta - 2.f * m1 - m2;
+        segment.C3 = m1 + m2 - 2.f * delta;
+        return segment;
+    }
+
+    /* Segments come from cooked, when given, otherwise they are computed for the evaluation */
+    template<class TKey>
+    static float Evaluate(const TKey* keys, int numKeys, int& cursor, float t, bool linear, const CurveSegment* cooked)
+    {
+        if(numKeys < 2)
+            return (numKeys == 1 ? ReadKey(keys, 0).Value : 0.f);
+
+        const int begin = FindSegment(keys, numKeys, cursor, t);
+        const Key k1 = ReadKey(keys, begin);
+        const Key k2 = ReadKey(keys, begin + 1);
+
+        // Coincident keys make a step, and t beyond either end clamps to the end values
+        const float width = k2.Alpha - k1.Alpha;
+        float local_t = (width > 0.f ? (t - k1.Alpha)/width : 1.f);
+        local_t = (local_t < 0.f ? 0.f : local_t > 1.f ? 1.f : local_t);
+
+        if(linear)
+        {
+            return Lerp(k1.Value, k2.Value, local_t);
+        }
+        else
+        {
+            const CurveSegment segment = (cooked ? cooked[begin] : ComputeSegment(keys, numKeys, begin));
+            return ((segment.C3 * local_t + segment.C2) * local_t + segment.C1) * local_t + k1.Value;
+        }
+    }
+}
+
+CurveView::CurveView(const FlashKey* keys, size_t count)
+    : m_Keys(keys)
+    , m_NumKeys(count)
+    , m_Cursor(0)
+{
+    assert(keys && count >= 2);
+}
+
+Key CurveView::GetKey(int atIdx) const
+{
+    assert(atIdx < m_NumKeys && atIdx >= 0);
+    return ReadKey(m_Keys, atIdx);
+}
+
+float CurveView::Evaluate(float t, bool linear) const
+{
+    return Interp::Evaluate(m_Keys, m_NumKeys, m_Cursor, t, linear, nullptr);
 }
 
 Curve::Curve(size_t capacity)
     : m_Capacity(capacity)
+    , m_Segments(nullptr)
+    , m_SegmentCapacity(0)
+    , m_bCooked(false)
+    , m_Cursor(0)
 {
     assert(capacity > 2);
     m_Keys = (Key*)calloc(capacity, sizeof(Key));
@@ -49,12 +212,17 @@ Curve::Curve(size_t capacity)
     m_NumKeys = 2;
 }
 
-Curve::Curve(Key* keys, size_t count)
+Curve::Curve(const Key* keys, size_t count)
+    : m_Segments(nullptr)
+    , m_SegmentCapacity(0)
+    , m_bCooked(false)
+    , m_Cursor(0)
 {
     assert(keys && count > 2);
     if(keys)
     {
-        m_Keys = (Key*)calloc(count * SLACK, sizeof(Key));
+        m_Capacity = count * SLACK;
+        m_Keys = (Key*)calloc(m_Capacity, sizeof(Key));
 
         //memcpy(m_Keys, keys, count);
         m_NumKeys = count;
@@ -66,11 +234,28 @@ Curve::Curve(Key* keys, size_t count)
     }
 }
 
+Curve::Curve(const CurveView& view)
+    : m_Segments(nullptr)
+    , m_SegmentCapacity(0)
+    , m_bCooked(false)
+    , m_Cursor(0)
+{
+    m_Capacity = view.GetNumKeys() * SLACK;
+    m_Keys = (Key*)calloc(m_Capacity, sizeof(Key));
+    m_NumKeys = view.GetNumKeys();
+
+    for(int i = 0; i < m_NumKeys; i++)
+    {
+        m_Keys[i] = view.GetKey(i);
+    }
+}
+
 Curve::Curve(const Curve& Other)
+    : m_Keys(nullptr)
+    , m_Segments(nullptr)
+    , m_SegmentCapacity(0)
 {
-    m_Keys = Other.m_Keys;
-    m_Capacity = Other.m_Capacity;
-    m_NumKeys = Other.m_NumKeys;
+    Clone(Other);
 }
 
 Curve::~Curve()
@@ -78,6 +263,9 @@ Curve::~Curve()
     assert(m_Keys);
     free(m_Keys);
     m_Keys = nullptr;
+
+    free(m_Segments);
+    m_Segments = nullptr;
 }
 
 void Curve::Clone(const Curve& Other)
@@ -89,22 +277,32 @@ void Curve::Clone(const Curve& Other)
     }
 
     m_Keys = (Key*)malloc(Other.m_Capacity * sizeof(Key));
-	m_Keys = Other.m_Keys;
 
     for(int i = 0; i < Other.m_NumKeys; i++)
     {
-    	//Key newKey;
-    	//newKey.Alpha = Other.m_Keys[i].Alpha;
-    	//newKey.Value = Other.m_Keys[i].Value;
-    	
-    	//m_Keys[i].Alpha = Other.m_Keys[i].Alpha;
-    	//m_Keys[i].Value = Other.m_Keys[i].Value;
-    	Serial.print("Copied: "); Serial.println(m_Keys[i].Alpha);
-	}
+        m_Keys[i] = Other.m_Keys[i];
+    }
     //memcpy(m_Keys, Other.m_Keys, Other.m_NumKeys);
 
     m_Capacity = Other.m_Capacity;
     m_NumKeys = Other.m_NumKeys;
+    m_Cursor = 0;
+
+    free(m_Segments);
+    m_Segments = nullptr;
+    m_SegmentCapacity = 0;
+    m_bCooked = Other.m_bCooked;
+
+    if(m_bCooked)
+    {
+        m_Segments = (CurveSegment*)malloc(Other.m_SegmentCapacity * sizeof(CurveSegment));
+        m_SegmentCapacity = Other.m_SegmentCapacity;
+
+        for(int i = 0; i < m_NumKeys - 1; i++)
+        {
+            m_Segments[i] = Other.m_Segments[i];
+        }
+    }
 }
 
 void Curve::AddKey(float alpha, float value)
@@ -115,7 +313,9 @@ void Curve::AddKey(float alpha, float value)
 
 void Curve::AddKey(const Key& k)
 {
-    if(m_NumKeys + 1 > m_Capacity);
+    m_bCooked = false;
+
+    if(m_NumKeys + 1 >= m_Capacity)
         Resize(m_Capacity * SLACK);
     
     // Overwriting last value
@@ -151,6 +351,7 @@ void Curve::AddKey(const Key& k)
 Key& Curve::EditKey(int atIdx)
 {
     assert(atIdx < m_NumKeys && atIdx >= 0);
+    m_bCooked = false;
     return m_Keys[atIdx];
 }
 
@@ -158,63 +359,23 @@ void Curve::RemoveKey(int atIdx)
 {
     assert(atIdx < m_NumKeys && atIdx >= 0);
     Remove(atIdx);
+    m_Cursor = 0;
+    m_bCooked = false;
 }
 
 float Curve::Evaluate(float t, bool linear) const
 {
-  linear = true;
-    int begin = 0;
-    int end = 0;
-
-    for(int i = 0; i < m_NumKeys; i++)
-    {
-        end = i;
-
-        // Our parameter is between these two points!
-        if(m_Keys[begin].Alpha <= t && m_Keys[end].Alpha > t)
-        {
-            break;
-        }
-        begin = i;
-    }
-	
-//	Serial.print("Begin: "); Serial.println(begin);
-//	Serial.print("End: "); Serial.println(end);
-
-    Key k1 = m_Keys[begin];
-    Key k2 = m_Keys[end];
-    const float local_t = (t - k1.Alpha)/(k2.Alpha - k1.Alpha);
-    if(linear)
-    {
-        return Interp::Lerp(k1.Value, k2.Value, local_t);
-    }
-    else
-    {
-        Key k0 = k1;
-        Key k3 = k2;
-
-        if(begin > 0)
-            k0 = m_Keys[begin-1];
-        if(end < m_NumKeys-1)
-            k3 = m_Keys[end+1];
-
-//		Serial.print("k0: "); Serial.println(k0.Value);
-//		Serial.print("k1: "); Serial.println(k1.Value);
-//		Serial.print("k2: "); Serial.println(k2.Value);
-//		Serial.print("k3: "); Serial.println(k3.Value);
-
-        return Interp::Cubic(k0.Value, k1.Value, k2.Value, k3.Value, local_t);
-    }
+    return Interp::Evaluate(m_Keys, m_NumKeys, m_Cursor, t, linear, (m_bCooked ? m_Segments : nullptr));
 }
 
 void Curve::Rebuild()
 {
-    // Cook the curve by resorting it by alpha values
-    for(int i = 0; i < m_NumKeys - 1; i++)
+    // Cook the curve by resorting it by alpha values, segment lookup relies on the order
+    for(int i = 1; i < m_NumKeys; i++)
     {
-        if(m_Keys[i].Alpha > m_Keys[i + 1].Alpha)
+        for(int j = i; j > 0 && m_Keys[j - 1].Alpha > m_Keys[j].Alpha; j--)
         {
-            Swap(m_Keys[i], m_Keys[i+1]);
+            Swap(m_Keys[j - 1], m_Keys[j]);
         }
     }
 
@@ -228,16 +389,32 @@ void Curve::Rebuild()
     if(m_Keys[m_NumKeys - 1].Alpha != 1.f)
     {
         Key k = { 1, m_Keys[m_NumKeys - 1].Value };
-        Insert(k, m_NumKeys-1);
+        Insert(k, m_NumKeys);
     }
+
+    m_Cursor = 0;
+
+    // Segments are cooked last, every key they depend on is in place
+    const size_t numSegments = m_NumKeys - 1;
+    if(m_SegmentCapacity < numSegments)
+    {
+        free(m_Segments);
+        m_SegmentCapacity = m_Capacity - 1;
+        m_Segments = (CurveSegment*)malloc(m_SegmentCapacity * sizeof(CurveSegment));
+    }
+
+    for(int i = 0; i < numSegments; i++)
+    {
+        m_Segments[i] = Interp::ComputeSegment(m_Keys, m_NumKeys, i);
+    }
+    m_bCooked = true;
 }
 
 void Curve::Insert(Key k, int atIdx)
 {
-    // Should never enter here
+    // Rebuild pads the curve without going through AddKey
     if(m_Capacity <= m_NumKeys + 1)
     {
-        assert(false); // for logical debugging
         Resize(m_Capacity * SLACK);
     }
 
@@ -257,18 +434,13 @@ void Curve::Remove(int atIdx)
     m_Keys[atIdx].Alpha = 0;
     m_Keys[atIdx].Value = 0;
 
-    // Should never enter here
-    if(m_Capacity <= m_NumKeys + 1)
-    {
-        assert(false); // for logical debugging
-        Resize(m_Capacity * SLACK);
-    }
-
     // Bubbles out the removed element
-    for(int i = atIdx; i < m_NumKeys; i++)
+    for(int i = atIdx; i < m_NumKeys - 1; i++)
     {
         Swap(m_Keys[i], m_Keys[i+1]);
     }
+
+    m_NumKeys--;
 }
 
 void Curve::Swap(Key& A, Key& B)
@@ -292,4 +464,5 @@ void Curve::Resize(size_t newCapacity)
 	
     free(m_Keys);
     m_Keys = newKeys;
+    m_Capacity = newCapacity;
 }
@@ -4,20 +4,71 @@
 #include <stdlib.h>
 
 #define SLACK (2)
+#define KARR_LEN(x) (sizeof(x)/sizeof((x)[0]))
+
 struct Key
 {
     float Alpha;
     float Value;
 };
 
+/*  Key stored in flash (PROGMEM). Same layout as Key, but a distinct type: flash keys can only be read through
+*   a CurveView, passing them where RAM keys are expected does not compile.
+*/
+struct FlashKey
+{
+    float Alpha;
+    float Value;
+};
+
+/*  Cubic Hermite coefficients of a segment, in the segment's local parameter s [0, 1]:
+*   f(s) = ((C3*s + C2)*s + C1)*s + Keys[begin].Value
+*/
+struct CurveSegment
+{
+    float C1;
+    float C2;
+    float C3;
+};
+
+/*  Read-only curve over keys in flash (PROGMEM), evaluated in place without copying the keys to RAM:
+*
+*       const FlashKey MyResponse[] PROGMEM = { {0, 0}, {0.5, 0.8}, {1, 1} };
+*       response.SetResponseCurve(CurveView(MyResponse, KARR_LEN(MyResponse)));
+*
+*   Keys must already be what Rebuild makes of a curve: sorted by alpha, from 0 to 1. Segments are computed
+*   on each evaluation, with the same result as a cooked Curve. To edit the keys, construct a Curve from the view.
+*/
+class CurveView
+{
+public:
+    CurveView(const FlashKey* keys, size_t count);
+
+    /* Same as Curve::Evaluate */
+    float Evaluate(float t, bool linear = false) const;
+
+    size_t GetNumKeys() const { return m_NumKeys; }
+    Key GetKey(int atIdx) const;
+private:
+    const FlashKey* m_Keys;
+    size_t m_NumKeys;
+
+    /* Segment of the last evaluation */
+    mutable int m_Cursor;
+};
+
 /*  Represent a polynomial Curve interpolated using
-*   a cubic Catmull Rom interpolation. 
+*   a monotone cubic Hermite interpolation (Fritsch-Carlson).
+*   Between keys of increasing (or decreasing) values, the curve never overshoots them.
 */
 class Curve
 {
 public:
     Curve(size_t capacity);
-    Curve(Key* keys, size_t count);
+    Curve(const Key* keys, size_t count);
+
+    /* Copies the keys of a view to RAM, for edits */
+    explicit Curve(const CurveView& view);
     Curve(const Curve& Other);
     ~Curve();
 
@@ -31,12 +82,14 @@ public:
     Key& EditKey(int atIdx);
     void RemoveKey(int atIdx);
 
-    /* Called after a curve has been modified to update and correct the curve values */
+    /* Called after a curve has been modified to update and correct the curve values, and cook the segments */
     void Rebuild();
 
-    /*  Evaluate the curve at some parameter t [0, 1].
+    /*  Evaluate the curve at some parameter t [0, 1]. Values beyond the first and last keys are held.
+    *   Segments are binary searched, starting from the segment of the previous evaluation.
     *   @Param t: Parameter or weight to interpolate with
-    *   @Param linear: If true, interpolation is a simple Lerp, otherwise use a Catmull Rom cubic interpolation
+    *   @Param linear: If true, interpolation is a simple Lerp, otherwise use a monotone cubic interpolation.
+    *   Curves edited since the last Rebuild compute the cubic of the segment on each evaluation
     */
     float Evaluate(float t, bool linear = false) const;
 
@@ -56,5 +109,13 @@ private:
     Key* m_Keys;
     size_t m_NumKeys;
     size_t m_Capacity;
+
+    /* Cooked by Rebuild, one per segment. Only valid until the keys are edited again */
+    CurveSegment* m_Segments;
+    size_t m_SegmentCapacity;
+    bool m_bCooked;
+
+    /* Segment of the last evaluation */
+    mutable int m_Cursor;
 };
 #endif // !CURVE_H
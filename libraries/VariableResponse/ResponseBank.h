@@ -0,0 +1,97 @@
+#ifndef RESPONSE_BANK_H
+#define RESPONSE_BANK_H
+
+#include <string.h>
+#include "VariableResponse.h"
+
+/*  Response Bank
+*
+*   Several responses to the same monitored variable over the same range, i.e one per LED color. Works like
+*   VariableResponse, with one table per channel, but the tables are interleaved: entry i of every channel
+*   side by side. A query clamps and normalizes the variable and finds its table position once, then each
+*   channel is a single integer lerp between neighbouring entries. More channels only add a table column.
+*
+*       ResponseBank<2> responses(RBf, 0.f, 1.f);
+*       responses.SetResponseCurve(0, CurveView(W_CoolWarmResponse, KARR_LEN(W_CoolWarmResponse)));
+*       responses.SetResponseCurve(1, CurveView(Y_CoolWarmResponse, KARR_LEN(Y_CoolWarmResponse)));
+*
+*       float values[2];
+*       responses.GetValues(values);
+*/
+template<uint8_t NumChannels>
+class ResponseBank
+{
+public:
+    ResponseBank(float& monitorVar, float min, float max)
+        : m_Scale(0.f)
+        , m_MonitorVar(monitorVar)
+        , m_MinVal(min)
+        , m_MaxVal(max)
+    {
+        // No response until curves are set
+        memset(m_Table, 0, sizeof(m_Table));
+        ResetRange(min, max);
+    }
+
+    void SetResponseCurve(uint8_t channel, const Curve& curve) { BakeResponseTable(curve, &m_Table[0][channel], NumChannels); }
+    void SetResponseCurve(uint8_t channel, const CurveView& curve) { BakeResponseTable(curve, &m_Table[0][channel], NumChannels); }
+
+    /* Rescales every channel at once */
+    void ResetRange(float newMin, float newMax)
+    {
+        m_MinVal = newMin;
+        m_MaxVal = newMax;
+        m_Scale = GetResponseScale(newMin, newMax);
+    }
+
+    /* Responses of every channel to the current value of the monitored variable, 0xFFFF being a full response */
+    void GetValuesQ16(uint16_t (&outValues)[NumChannels]) const
+    {
+        const uint16_t position = GetResponsePosition(m_MonitorVar, m_MinVal, m_Scale);
+
+        const uint8_t index = position >> VR_POSITION_BITS;
+        if(index == VR_TABLE_SIZE)
+        {
+            memcpy(outValues, m_Table[VR_TABLE_SIZE], sizeof(outValues));
+            return;
+        }
+
+        const uint8_t fraction = position & ((1 << VR_POSITION_BITS) - 1);
+        const uint16_t* from = m_Table[index];
+        const uint16_t* to = m_Table[index + 1];
+        for(uint8_t channel = 0; channel < NumChannels; channel++)
+        {
+            outValues[channel] = LerpResponse(from[channel], to[channel], fraction);
+        }
+    }
+
+    void GetValues(float (&outValues)[NumChannels]) const
+    {
+        uint16_t values[NumChannels];
+        GetValuesQ16(values);
+
+        for(uint8_t channel = 0; channel < NumChannels; channel++)
+        {
+            outValues[channel] = values[channel] * (1.f / 65535.f);
+        }
+    }
+
+    inline float GetMin() const { return m_MinVal; }
+    inline float GetMax() const { return m_MaxVal; }
+
+    float DebugGetParameter() const { return GetResponseParameter(m_MonitorVar, m_MinVal, m_MaxVal); }
+private:
+    /* Row i holds every channel's curve sampled at i / VR_TABLE_SIZE, both ends included */
+    uint16_t m_Table[VR_TABLE_SIZE + 1][NumChannels];
+
+    /* Table positions per unit of the monitored variable */
+    float m_Scale;
+
+    /* Non-nullable reference to variable being monitored */
+    float& m_MonitorVar;
+
+    /* Represent the range of the monitored variable, shared by all channels */
+    float m_MinVal;
+    float m_MaxVal;
+};
+#endif // !RESPONSE_BANK_H
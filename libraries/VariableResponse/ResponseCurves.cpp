@@ -0,0 +1,29 @@
+#include "ResponseCurves.h"
+
+/* Response of White light in response to changes to a parameterized value t*/
+const FlashKey W_CoolWarmResponse[5] PROGMEM =
+{
+    {0, 0.0},
+    {0.25, 0.1},
+    {0.5, 0.4},     // Neutral Light
+    {0.75, 0.8},
+    {1, 1}       // Maximum 100% brightness when at maximum response
+};
+
+const FlashKey Y_CoolWarmResponse[5] PROGMEM =
+{
+	{0, 1},
+	{0.25, 0.8},
+	{0.5, 0.4},
+	{0.75, 0.1},
+	{1, 0.00}
+};
+
+const FlashKey R_CCResponse[5] PROGMEM =
+{
+	{0, 0.2},
+	{0.25, 0.15},
+  {0.5, 0.1},
+	{0.75, 0.05},
+	{1, 0.0}
+};
@@ -1,34 +1,14 @@
 #ifndef RESPONSE_CURVES_H
 #define RESPONSE_CURVES_H
 
+#include <avr/pgmspace.h>
 #include "Curve.h"
 
-#define KARR_LEN(x) (sizeof(x)/sizeof(Key))
-/* Response of White light in response to changes to a parameterized value t*/
-static Key W_CoolWarmResponse[]
-{
-    {0, 0.0},
-    {0.25, 0.1},
-    {0.5, 0.4},     // Neutral Light
-    {0.75, 0.8},
-    {1, 1}       // Maximum 100% brightness when at maximum response
-};
+/*  Response templates, in flash. Defined once in ResponseCurves.cpp, evaluate them in place through a CurveView:
+*   CurveView(W_CoolWarmResponse, KARR_LEN(W_CoolWarmResponse))
+*/
 
-static Key Y_CoolWarmResponse[]
-{
-	{0, 1},
-	{0.25, 0.8},
-	{0.5, 0.4},
-	{0.75, 0.1},
-	{1, 0.00}
-};
-
-static Key R_CCResponse[]
-{
-	{0, 0.2},
-	{0.25, 0.15},
-  {0.5, 0.1},
-	{0.75, 0.05},
-	{1, 0.0}
-};
+extern const FlashKey W_CoolWarmResponse[5] PROGMEM;   // White, brightens as t rises
+extern const FlashKey Y_CoolWarmResponse[5] PROGMEM;   // Yellow, dims as t rises
+extern const FlashKey R_CCResponse[5] PROGMEM;
 #endif // !RESPONSE_CURVES_H
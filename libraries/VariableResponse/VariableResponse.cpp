@@ -1,42 +1,100 @@
 #include "VariableResponse.h"
 
+#include <string.h>
+
 static inline float Clamp(float val, float min, float max)
 {
 	return val < min ? min : val > max ? max : val;	
 }
 
 VariableResponse::VariableResponse(float& monitorVar, float min, float max)
-    : m_Curve(Curve(4))
+    : m_Scale(0.f)
     , m_MonitorVar(monitorVar)
     , m_MinVal(min)
     , m_MaxVal(max)
 {
-
+    // No response until a curve is set
+    memset(m_Table, 0, sizeof(m_Table));
+    ResetRange(min, max);
 }
 
 void VariableResponse::SetResponseCurve(const Curve& curve)
 {
-    // Just deep copy its ass
-    m_Curve.Clone(curve);
+    BakeResponseTable(curve, m_Table);
+}
+
+void VariableResponse::SetResponseCurve(const CurveView& curve)
+{
+    BakeResponseTable(curve, m_Table);
 }
 
 void VariableResponse::ResetRange(float newMin, float newMax)
 {
     m_MinVal = newMin;
     m_MaxVal = newMax;
+
+    // A collapsed range (i.e before calibration) has no meaningful parameter, hold the start of the curve
+    m_Scale = GetResponseScale(newMin, newMax);
+}
+
+uint16_t VariableResponse::GetValueQ16() const
+{
+    const uint16_t position = GetResponsePosition(m_MonitorVar, m_MinVal, m_Scale);
+
+    const uint8_t index = position >> VR_POSITION_BITS;
+    if(index == VR_TABLE_SIZE)
+        return m_Table[VR_TABLE_SIZE];
+
+    return LerpResponse(m_Table[index], m_Table[index + 1], position & ((1 << VR_POSITION_BITS) - 1));
 }
 
 float VariableResponse::GetValue() const
 {
-    const float clampedVar = Clamp(m_MonitorVar, m_MinVal, m_MaxVal);
-    float t = (clampedVar - m_MinVal)/(m_MaxVal - m_MinVal);
-  if (t == 1) t -= 0.1;
-    return m_Curve.Evaluate(t);
+    return GetValueQ16() * (1.f / 65535.f);
 }
 
 float VariableResponse::DebugGetParameter() {
-  const float clampedVar = Clamp(m_MonitorVar, m_MinVal, m_MaxVal);
-  float t = (clampedVar - m_MinVal)/(m_MaxVal - m_MinVal);
-  if (t == 1) t -= 0.1;
-  return t;
+  return GetResponseParameter(m_MonitorVar, m_MinVal, m_MaxVal);
+}
+
+/* Curves and views evaluate the same */
+template<class TCurve>
+static void BakeTable(const TCurve& curve, uint16_t* table, size_t stride)
+{
+    for(int i = 0; i <= VR_TABLE_SIZE; i++)
+    {
+        const float value = Clamp(curve.Evaluate((float)i / VR_TABLE_SIZE), 0.f, 1.f);
+        table[i * stride] = (uint16_t)(value * 65535.f + 0.5f);
+    }
+}
+
+void BakeResponseTable(const Curve& curve, uint16_t* table, size_t stride)
+{
+    BakeTable(curve, table, stride);
+}
+
+void BakeResponseTable(const CurveView& curve, uint16_t* table, size_t stride)
+{
+    BakeTable(curve, table, stride);
+}
+
+float GetResponseScale(float min, float max)
+{
+    return (max > min ? VR_POSITION_END / (max - min) : 0.f);
+}
+
+uint16_t GetResponsePosition(float value, float min, float scale)
+{
+    // Clamped while still a float, the unclamped product may not fit any integer
+    const float scaled = (value - min) * scale;
+    return (scaled <= 0.f ? 0 : scaled >= VR_POSITION_END ? VR_POSITION_END : (uint16_t)scaled);
+}
+
+float GetResponseParameter(float value, float min, float max)
+{
+    if(max <= min)
+        return 0.f;
+
+    const float clampedVar = Clamp(value, min, max);
+    return (clampedVar - min)/(max - min);
 }
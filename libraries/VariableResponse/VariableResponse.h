@@ -1,8 +1,37 @@
 #ifndef VARIABLE_RESPONSE_H
 #define VARIABLE_RESPONSE_H
 
+#include <stdint.h>
 #include "Curve.h"
 
+/* The response curve is baked into 2^VR_TABLE_BITS segments, linearly interpolated */
+#define VR_TABLE_BITS 6
+#define VR_TABLE_SIZE (1 << VR_TABLE_BITS)
+
+/* Fractional bits of a position within the table */
+#define VR_POSITION_BITS 8
+#define VR_POSITION_END ((uint16_t)VR_TABLE_SIZE << VR_POSITION_BITS)
+
+/*  Table building blocks, shared with ResponseBank */
+
+/* Samples a curve into VR_TABLE_SIZE + 1 entries, stride entries apart */
+void BakeResponseTable(const Curve& curve, uint16_t* table, size_t stride = 1);
+void BakeResponseTable(const CurveView& curve, uint16_t* table, size_t stride = 1);
+
+/* Table positions per unit of the monitored variable. A collapsed range (i.e before calibration) scales to 0 */
+float GetResponseScale(float min, float max);
+
+/* Position of the monitored variable within a table, clamped to [0, VR_POSITION_END] */
+uint16_t GetResponsePosition(float value, float min, float scale);
+
+/* Monitored variable normalized to [0, 1] over the range */
+float GetResponseParameter(float value, float min, float max);
+
+inline uint16_t LerpResponse(int32_t from, int32_t to, uint8_t fraction)
+{
+    return (uint16_t)(from + (((to - from) * fraction) >> VR_POSITION_BITS));
+}
+
 /*  Variable Response
 *
 *   A poorly named class that simply outputs a response value
@@ -10,6 +39,12 @@
 *   to the monitored variable is dictated by a curve that best fits
 *   the required output characteristic. i.e How much brightness compensation is 
 *   needed for a change in an intensity variable.
+*
+*   The curve is sampled once, in SetResponseCurve, into a Q0.16 table over its parameter [0, 1]. Flash curves
+*   are sampled in place through a CurveView. A query is then a single multiply into a table position and an
+*   integer lerp between two entries. The table does not depend on the range, ResetRange (i.e after calibration)
+*   only rescales positions and never resamples.
+*   Responses are brightness fractions: curve values are saturated to [0, 1].
 */
 class VariableResponse
 {
@@ -17,14 +52,25 @@ public:
     VariableResponse(float& monitorVar, float min, float max);
 
     void SetResponseCurve(const Curve& curve);
+    void SetResponseCurve(const CurveView& curve);
     void ResetRange(float newMin, float newMax);
 
     /* Returns the response to the currently monitored variable based on interpolation on a curve */
     float GetValue() const;
+
+    /* Same response in Q0.16, 0xFFFF being a full response */
+    uint16_t GetValueQ16() const;
+
+    inline float GetMin() const { return m_MinVal; }
+    inline float GetMax() const { return m_MaxVal; }
     
     float DebugGetParameter();
 private:
-    Curve m_Curve;
+    /* Curve sampled at i / VR_TABLE_SIZE, both ends included */
+    uint16_t m_Table[VR_TABLE_SIZE + 1];
+
+    /* Table positions per unit of the monitored variable */
+    float m_Scale;
 
     /* Non-nullable reference to variable being monitored */
     float& m_MonitorVar;